@@ -17,11 +17,13 @@
 #include "addr.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include "app_mode.h"
 #include "coin.h"
 #include "crypto.h"
 #include "crypto_helper.h"
+#include "format_helper.h"
 #include "os.h"
 #include "parser_txdef.h"
 #include "tx.h"
@@ -31,12 +33,10 @@
 
 address_request_t addr_request = {0};
 
-#define BUFF_FIRST_ACCOUNT_INDEX 3
-#define VAULT_INFO_SIZE 24  // TODO: avoid hardcoding sizes
-
 zxerr_t clearAddressRequest() {
     addr_request.account_type = UNKNOWN;
     addr_request.optional_numberOfPubkeys = 0;
+    tx_addr_review()->numItems = 0;
     return zxerr_ok;
 }
 
@@ -45,81 +45,11 @@ zxerr_t readAddressRequest(account_type_e account_type) {
         return zxerr_unknown;
     }
 
-    const uint8_t *message = tx_get_buffer();
-    const uint16_t messageLength = tx_get_buffer_length();
-
-    switch (account_type) {
-        case MULTISIG:
-        case VESTING: {
-            addr_request.internalIndex = message[0];
-
-            // TODO: misaligned access throw in this CPU. Be careful with misaligned u32
-            addr_request.account = (generic_account_t *)(message + 1);
-
-            uint8_t pubkeysBuffSize = messageLength - BUFF_FIRST_ACCOUNT_INDEX;
-            // Ensure the buffer size is a multiple of pubkey_item_t
-            if (pubkeysBuffSize % sizeof(pubkey_item_t) != 0) {
-                return zxerr_invalid_crypto_settings;
-            }
-
-            addr_request.optional_numberOfPubkeys = (pubkeysBuffSize / sizeof(pubkey_item_t));
-
-            // Validate the number of public keys
-            if (addr_request.optional_numberOfPubkeys + 1 != addr_request.account->participants) {
-                return zxerr_invalid_crypto_settings;
-            }
-
-            // validate account
-            uint8_t indexAux = 0;
-            for (int i = 0; i < addr_request.optional_numberOfPubkeys + 1; i++) {
-                if (i == addr_request.internalIndex) {
-                    continue;
-                }
-                if (i == addr_request.account->keys[indexAux].index) {
-                    indexAux++;
-                } else {
-                    return zxerr_invalid_crypto_settings;
-                }
-            }
-            break;
-        }
-        case VAULT: {
-            addr_request.internalIndex = message[0];
-            addr_request.vault_account = (vault_account_t *)(message + 1);
-
-            uint8_t pubkeysBuffSize = messageLength - (BUFF_FIRST_ACCOUNT_INDEX + VAULT_INFO_SIZE);
-            // Ensure the buffer size is a multiple of pubkey_item_t s
-            if (pubkeysBuffSize % sizeof(pubkey_item_t) != 0) {
-                return zxerr_invalid_crypto_settings;
-            }
-
-            addr_request.optional_numberOfPubkeys = (pubkeysBuffSize / sizeof(pubkey_item_t));
-
-            // Validate the number of public keys
-            if (addr_request.optional_numberOfPubkeys + 1 != addr_request.vault_account->owner.participants) {
-                return zxerr_invalid_crypto_settings;
-            }
-
-            // create account
-            uint8_t indexAux = 0;
-            for (int i = 0; i < addr_request.optional_numberOfPubkeys + 1; i++) {
-                if (i == addr_request.internalIndex) {
-                    continue;
-                }
-                if (i == addr_request.vault_account->owner.keys[indexAux].index) {
-                    indexAux++;
-                } else {
-                    return zxerr_invalid_crypto_settings;
-                }
-            }
-            break;
-        }
-        default:
-            return zxerr_encoding_failed;
-    }
+    address_request_t request = {0};
+    CHECK_ZXERR(parseAddressRequest(tx_get_buffer(), (uint16_t)tx_get_buffer_length(), account_type, &request))
 
-    // Only where everything is fine, mark the account type
-    addr_request.account_type = account_type;
+    // Only where everything is fine, keep the request and its account type
+    addr_request = request;
     return zxerr_ok;
 }
 
@@ -156,7 +86,7 @@ zxerr_t wallet_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char
     }
 }
 
-static zxerr_t getPublicKey(const uint8_t index, const uint8_t internalIndex, pubkey_item_t *keys,
+static zxerr_t getPublicKey(const uint8_t index, const uint8_t internalIndex, const pubkey_item_t *keys,
                             const uint8_t **pubkeyPtr) {
     if (keys == NULL || pubkeyPtr == NULL) {
         return zxerr_no_data;
@@ -172,84 +102,150 @@ static zxerr_t getPublicKey(const uint8_t index, const uint8_t internalIndex, pu
     return zxerr_ok;
 }
 
-zxerr_t multisigVesting_getNumItems(uint8_t *num_items) {
-    ZEMU_LOGF(50, "multisigVesting_getNumItems\n");
+static char *addReviewItem(const char *key) {
+    addr_review_t *review = tx_addr_review();
+    if (review->numItems >= ADDR_REVIEW_MAX_ITEMS || review->textLen >= ADDR_REVIEW_TEXT_LEN) {
+        return NULL;
+    }
+    addr_review_item_t *item = &review->items[review->numItems++];
+    item->key = key;
+    item->value = review->textLen;
+    return review->text + review->textLen;
+}
 
-    if (addr_request.account_type != MULTISIG && addr_request.account_type != VESTING) {
-        return zxerr_encoding_failed;
+// Keeps the value just written by the last addReviewItem
+static zxerr_t commitReviewItem() {
+    addr_review_t *review = tx_addr_review();
+    const uint16_t remaining = ADDR_REVIEW_TEXT_LEN - review->textLen;
+    const size_t len = strnlen(review->text + review->textLen, remaining);
+    if (len >= remaining) {
+        return zxerr_buffer_too_small;
     }
+    review->textLen += (uint16_t)(len + 1);
+    return zxerr_ok;
+}
 
-    const uint8_t fixedFields = 5;  // Participants, Approvers, internal pubkey
-                                    // + address + path
+static zxerr_t addReviewString(const char *key, const char *value) {
+    addr_review_t *review = tx_addr_review();
+    char *out = addReviewItem(key);
+    if (out == NULL) {
+        return zxerr_buffer_too_small;
+    }
+    snprintf(out, ADDR_REVIEW_TEXT_LEN - review->textLen, "%s", value);
+    return commitReviewItem();
+}
 
-    // Everything from above
-    *num_items = addr_request.optional_numberOfPubkeys + fixedFields;
-    return zxerr_ok;
+static zxerr_t addReviewNumber(const char *key, uint64_t value) {
+    addr_review_t *review = tx_addr_review();
+    char *out = addReviewItem(key);
+    if (out == NULL || uint64_to_str(out, ADDR_REVIEW_TEXT_LEN - review->textLen, value) != NULL) {
+        return zxerr_buffer_too_small;
+    }
+    return commitReviewItem();
 }
 
-zxerr_t multisigVesting_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char *outVal, uint16_t outValLen,
-                                uint8_t pageIdx, uint8_t *pageCount) {
-    ZEMU_LOGF(50, "[multisigVesting_getItem] %d/%d\n", displayIdx, pageIdx)
+zxerr_t addr_prepareReview() {
+    addr_review_t *review = tx_addr_review();
+    MEMZERO(review, sizeof(*review));
 
-    if (addr_request.account_type != MULTISIG && addr_request.account_type != VESTING) {
-        return zxerr_invalid_crypto_settings;
+    const char *title = NULL;
+    switch (addr_request.account_type) {
+        case MULTISIG:
+            title = "Multisig";
+            break;
+        case VESTING:
+            title = "Vesting";
+            break;
+        case VAULT:
+            title = "Vault";
+            break;
+        default:
+            return zxerr_invalid_crypto_settings;
     }
 
-    uint8_t numItems = 0;
-    multisigVesting_getNumItems(&numItems);
+    CHECK_ZXERR(addReviewString(title, (const char *)(G_io_apdu_buffer + PUB_KEY_LENGTH)))
+
+    char *path = addReviewItem("HD Path");
+    if (path == NULL) {
+        return zxerr_buffer_too_small;
+    }
+    bip32_to_str(path, ADDR_REVIEW_TEXT_LEN - review->textLen, hdPath, HDPATH_LEN_DEFAULT);
+    CHECK_ZXERR(commitReviewItem())
+
+    if (addr_request.account_type == VAULT) {
+        CHECK_ZXERR(addReviewNumber("TotalAmount", addr_request.vault_account.totalAmount))
+        CHECK_ZXERR(addReviewNumber("InitialUnlock", addr_request.vault_account.initialUnlockAmount))
+        CHECK_ZXERR(addReviewNumber("Start", addr_request.vault_account.vestingStart))
+        CHECK_ZXERR(addReviewNumber("End", addr_request.vault_account.vestingEnd))
+    }
+    CHECK_ZXERR(addReviewNumber("Participants", addr_request.account->participants))
+    CHECK_ZXERR(addReviewNumber("Validators", addr_request.account->approvers))
 
-    if (displayIdx >= numItems) {
+    for (uint8_t i = 0; i < addr_request.account->participants; i++) {
+        if (review->numItems >= ADDR_REVIEW_MAX_ITEMS) {
+            return zxerr_buffer_too_small;
+        }
+        addr_review_item_t *item = &review->items[review->numItems++];
+        item->key = NULL;
+        item->value = i;
+    }
+    return zxerr_ok;
+}
+
+static zxerr_t addr_getReviewItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char *outVal, uint16_t outValLen,
+                                  uint8_t pageIdx, uint8_t *pageCount) {
+    const addr_review_t *review = tx_addr_review();
+    if (displayIdx < 0 || displayIdx >= review->numItems) {
         return zxerr_no_data;
     }
 
     *pageCount = 1;
-    switch ((uint8_t)displayIdx) {
-        case 0:
-            if (addr_request.account_type == MULTISIG) {
-                snprintf(outKey, outKeyLen, "Multisig");
-            } else {
-                snprintf(outKey, outKeyLen, "Vesting");
-            }
-            pageString(outVal, outValLen, (char *)(G_io_apdu_buffer + PUB_KEY_LENGTH), pageIdx, pageCount);
-            return zxerr_ok;
-
-        case 1: {
-            snprintf(outKey, outKeyLen, "HD Path");
-            char buffer[300] = {0};
-            bip32_to_str(buffer, sizeof(buffer), hdPath, HDPATH_LEN_DEFAULT);
-            pageString(outVal, outValLen, buffer, pageIdx, pageCount);
-            return zxerr_ok;
+    const addr_review_item_t *item = &review->items[displayIdx];
+    if (item->key == NULL) {
+        const uint8_t *pubkeyPtr = NULL;
+        snprintf(outKey, outKeyLen, "Pubkey %d", item->value);
+        CHECK_ZXERR(getPublicKey((uint8_t)item->value, addr_request.internalIndex, addr_request.account->keys, &pubkeyPtr))
+        if (pageHexString(outVal, outValLen, pubkeyPtr, PUB_KEY_LENGTH, false, 0, pageIdx, pageCount) != parser_ok) {
+            return zxerr_unknown;
         }
+        return zxerr_ok;
+    }
 
-        case 2:
-            snprintf(outKey, outKeyLen, "Participants");
-            snprintf(outVal, outValLen, "%d", addr_request.account->participants);
-            return zxerr_ok;
+    snprintf(outKey, outKeyLen, "%s", (const char *)PIC(item->key));
+    pageString(outVal, outValLen, review->text + item->value, pageIdx, pageCount);
+    return zxerr_ok;
+}
 
-        case 3:
-            snprintf(outKey, outKeyLen, "Validators");
-            snprintf(outVal, outValLen, "%d", addr_request.account->approvers);
-            return zxerr_ok;
+zxerr_t multisigVesting_getNumItems(uint8_t *num_items) {
+    ZEMU_LOGF(50, "multisigVesting_getNumItems\n");
 
-        case 255:
-            if (addr_request.account_type == MULTISIG) {
-                snprintf(outVal, outKeyLen, "Review Multisig address");
-            } else {
-                snprintf(outVal, outKeyLen, "Review Vesting address");
-            }
-            return zxerr_ok;
+    if (addr_request.account_type != MULTISIG && addr_request.account_type != VESTING) {
+        return zxerr_encoding_failed;
+    }
 
-        default: {
-            const uint8_t tmpDisplayIdx = displayIdx - 4;
-            const uint8_t *pubkeyPtr = NULL;
-            snprintf(outKey, outKeyLen, "Pubkey %d", tmpDisplayIdx);
-            CHECK_ZXERR(getPublicKey(tmpDisplayIdx, addr_request.internalIndex, addr_request.account->keys, &pubkeyPtr))
-            pageStringHex(outVal, outValLen, (const char *)pubkeyPtr, PUB_KEY_LENGTH, pageIdx, pageCount);
-            return zxerr_ok;
+    // Address, path, participants, approvers and every pubkey
+    *num_items = tx_addr_review()->numItems;
+    return zxerr_ok;
+}
+
+zxerr_t multisigVesting_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char *outVal, uint16_t outValLen,
+                                uint8_t pageIdx, uint8_t *pageCount) {
+    ZEMU_LOGF(50, "[multisigVesting_getItem] %d/%d\n", displayIdx, pageIdx)
+
+    if (addr_request.account_type != MULTISIG && addr_request.account_type != VESTING) {
+        return zxerr_invalid_crypto_settings;
+    }
+
+    if ((uint8_t)displayIdx == 255) {
+        if (addr_request.account_type == MULTISIG) {
+            snprintf(outVal, outKeyLen, "Review Multisig address");
+        } else {
+            snprintf(outVal, outKeyLen, "Review Vesting address");
         }
+        return zxerr_ok;
     }
 
-    return zxerr_no_data;
+    return addr_getReviewItem(displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
 }
 
 zxerr_t vault_getNumItems(uint8_t *num_items) {
@@ -259,11 +255,8 @@ zxerr_t vault_getNumItems(uint8_t *num_items) {
         return zxerr_encoding_failed;
     }
 
-    // TotalAmount, InitialUnlockAmount, vestingStart, vestingEnd, Participants, Approvers, internal pubkey
-    const uint8_t fixedFields = 7;
-
-    // Everything from above + address + path
-    *num_items = addr_request.optional_numberOfPubkeys + fixedFields + 2;
+    // Address, path, the four vault terms, participants, approvers and every pubkey
+    *num_items = tx_addr_review()->numItems;
     return zxerr_ok;
 }
 
@@ -275,81 +268,10 @@ zxerr_t vault_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char
         return zxerr_encoding_failed;
     }
 
-    uint8_t numItems = 0;
-    vault_getNumItems(&numItems);
-    if (displayIdx >= numItems) {
-        return zxerr_no_data;
-    }
-    *pageCount = 1;
-
-    char tmpBuffer[30] = {0};
-    switch ((uint8_t)displayIdx) {
-        case 0:
-            snprintf(outKey, outKeyLen, "Vault");
-            snprintf(outVal, outValLen, "%d", addr_request.internalIndex);
-            pageString(outVal, outValLen, (char *)(G_io_apdu_buffer + PUB_KEY_LENGTH), pageIdx, pageCount);
-            break;
-
-        case 1: {
-            snprintf(outKey, outKeyLen, "HD Path");
-            char buffer[300] = {0};
-            bip32_to_str(buffer, sizeof(buffer), hdPath, HDPATH_LEN_DEFAULT);
-            pageString(outVal, outValLen, buffer, pageIdx, pageCount);
-            break;
-        }
-
-        case 2: {
-            snprintf(outKey, outKeyLen, "TotalAmount");
-            if (uint64_to_str(tmpBuffer, sizeof(tmpBuffer), addr_request.vault_account->totalAmount) != NULL) {
-                return zxerr_unknown;
-            }
-            pageStringExt(outVal, outValLen, tmpBuffer, sizeof(tmpBuffer), pageIdx, pageCount);
-            break;
-        }
-
-        case 3: {
-            snprintf(outKey, outKeyLen, "InitialUnlock");
-            if (uint64_to_str(tmpBuffer, sizeof(tmpBuffer), addr_request.vault_account->initialUnlockAmount) != NULL) {
-                return zxerr_unknown;
-            }
-            pageStringExt(outVal, outValLen, tmpBuffer, sizeof(tmpBuffer), pageIdx, pageCount);
-            break;
-        }
-
-        case 4:
-            snprintf(outKey, outKeyLen, "Start");
-            snprintf(outVal, outValLen, "%d", addr_request.vault_account->vestingStart);
-            break;
-
-        case 5:
-            snprintf(outKey, outKeyLen, "End");
-            snprintf(outVal, outValLen, "%d", addr_request.vault_account->vestingEnd);
-            break;
-
-        case 6:
-            snprintf(outKey, outKeyLen, "Participants");
-            snprintf(outVal, outValLen, "%d", addr_request.vault_account->owner.participants);
-            break;
-
-        case 7:
-            snprintf(outKey, outKeyLen, "Validators");
-            snprintf(outVal, outValLen, "%d", addr_request.vault_account->owner.approvers);
-            break;
-
-        case 255:
-            snprintf(outVal, outKeyLen, "Review Vault address");
-            break;
-
-        default: {
-            const uint8_t tmpDisplayIdx = displayIdx - 8;
-            const uint8_t *pubkeyPtr = NULL;
-            snprintf(outKey, outKeyLen, "Pubkey %d", tmpDisplayIdx);
-            CHECK_ZXERR(
-                getPublicKey(tmpDisplayIdx, addr_request.internalIndex, addr_request.vault_account->owner.keys, &pubkeyPtr))
-            pageStringHex(outVal, outValLen, (const char *)pubkeyPtr, PUB_KEY_LENGTH, pageIdx, pageCount);
-            break;
-        }
+    if ((uint8_t)displayIdx == 255) {
+        snprintf(outVal, outKeyLen, "Review Vault address");
+        return zxerr_ok;
     }
 
-    return zxerr_ok;
+    return addr_getReviewItem(displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
 }
@@ -25,8 +25,31 @@ extern "C" {
 
 #include "crypto_helper.h"
 
+// Review items of the last multisig, vesting or vault request. Every text value is formatted once, when the address is
+// derived, and the getItem callbacks only page through it. Pubkeys are paged straight from their bytes. Stored over
+// the parsed tx, see tx_addr_review.
+#define ADDR_REVIEW_MAX_ITEMS (8 + MAX_MULTISIG_PUB_KEY)
+// Address, path, two u64 amounts, two u32 times and two counts, with their terminators
+#define ADDR_REVIEW_TEXT_LEN 224
+
+typedef struct {
+    // NULL for pubkey items, which are labelled by their number
+    const char *key;
+    // Offset of the value in text, or the pubkey number of pubkey items
+    uint16_t value;
+} addr_review_item_t;
+
+typedef struct {
+    uint8_t numItems;
+    uint16_t textLen;
+    addr_review_item_t items[ADDR_REVIEW_MAX_ITEMS];
+    char text[ADDR_REVIEW_TEXT_LEN];
+} addr_review_t;
+
 zxerr_t clearAddressRequest();
 zxerr_t readAddressRequest(account_type_e account_type);
+// Formats the review items of the multisig, vesting or vault address just derived
+zxerr_t addr_prepareReview();
 
 zxerr_t wallet_getNumItems(uint8_t *num_items);
 zxerr_t wallet_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char *outValue, uint16_t outValueLen,
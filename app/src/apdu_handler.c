@@ -34,6 +34,7 @@
 
 static bool tx_initialized = false;
 static bool requireConfirmation = false;
+static uint8_t displayFlags = 0;
 extern account_type_e addr_review_account_type;
 
 static const char *MULTISIG_TITLE = "Multisig address";
@@ -67,7 +68,8 @@ void extractHDPath(uint32_t rx, uint32_t offset) {
     }
 }
 
-__Z_INLINE bool process_chunk(__Z_UNUSED volatile uint32_t *tx, uint32_t rx) {
+// withDisplayFlags takes the DISPLAY_FLAG_* bits from P2, address requests predate them and ignore P2
+__Z_INLINE bool process_chunk(__Z_UNUSED volatile uint32_t *tx, uint32_t rx, bool withDisplayFlags) {
     const uint8_t payloadType = G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE];
     if (rx < OFFSET_DATA) {
         THROW(APDU_CODE_WRONG_LENGTH);
@@ -76,10 +78,16 @@ __Z_INLINE bool process_chunk(__Z_UNUSED volatile uint32_t *tx, uint32_t rx) {
     uint32_t added;
     switch (payloadType) {
         case P1_INIT:
+            // Unknown flags are rejected, so a host never relies on a review mode this app does not implement
+            if (withDisplayFlags && (G_io_apdu_buffer[OFFSET_P2] & ~DISPLAY_FLAGS_KNOWN) != 0) {
+                tx_initialized = false;
+                THROW(APDU_CODE_INVALIDP1P2);
+            }
             tx_initialize();
             tx_reset();
             extractHDPath(rx, OFFSET_DATA);
             requireConfirmation = G_io_apdu_buffer[OFFSET_P1];
+            displayFlags = withDisplayFlags ? G_io_apdu_buffer[OFFSET_P2] : 0;
             tx_initialized = true;
             return false;
         case P1_ADD:
@@ -129,12 +137,12 @@ __Z_INLINE void handleGetAddr(volatile uint32_t *flags, volatile uint32_t *tx, u
 
 __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
     ZEMU_LOGF(50, "handleSign %d\n", rx);
-    if (!process_chunk(tx, rx)) {
+    if (!process_chunk(tx, rx, true)) {
         THROW(APDU_CODE_OK);
     }
 
     *tx = 0;
-    const char *error_msg = tx_parse();
+    const char *error_msg = tx_parse(displayFlags);
     CHECK_APP_CANARY()
     if (error_msg != NULL) {
         const int error_msg_length = strnlen(error_msg, sizeof(G_io_apdu_buffer));
@@ -150,12 +158,22 @@ __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx, uint
 
 __Z_INLINE void handleSignMessage(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
     ZEMU_LOGF(50, "handleSignMessage\n");
-    if (!process_chunk(tx, rx)) {
+    const uint8_t payloadType = G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE];
+    const bool lastChunk = process_chunk(tx, rx, true);
+
+    // Chunks are hashed as they arrive, so long binary messages can be reviewed by digest without another pass
+    if (payloadType == P1_INIT) {
+        tx_message_digest_init();
+    } else if (displayFlags & DISPLAY_FLAG_MESSAGE_DIGEST) {
+        tx_message_digest_update(&G_io_apdu_buffer[OFFSET_DATA], (uint16_t)(rx - OFFSET_DATA));
+    }
+
+    if (!lastChunk) {
         THROW(APDU_CODE_OK);
     }
 
     *tx = 0;
-    const char *error_msg = tx_message_parse();
+    const char *error_msg = tx_message_parse(displayFlags);
     CHECK_APP_CANARY()
     if (error_msg != NULL) {
         const int error_msg_length = strnlen(error_msg, sizeof(G_io_apdu_buffer));
@@ -169,10 +187,29 @@ __Z_INLINE void handleSignMessage(volatile uint32_t *flags, volatile uint32_t *t
     *flags |= IO_ASYNCH_REPLY;
 }
 
+// Same upload as handleSign, answers with the parser diagnostics instead of starting a review
+__Z_INLINE void handleValidateTx(__Z_UNUSED volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    ZEMU_LOGF(50, "handleValidateTx %d\n", rx);
+    if (!process_chunk(tx, rx, true)) {
+        THROW(APDU_CODE_OK);
+    }
+
+    uint16_t errorOffset = 0;
+    uint8_t numItems = 0;
+    const uint8_t error = tx_validate(displayFlags, &errorOffset, &numItems);
+
+    G_io_apdu_buffer[0] = error;
+    G_io_apdu_buffer[1] = (errorOffset >> 8) & 0xFF;
+    G_io_apdu_buffer[2] = (errorOffset >> 0) & 0xFF;
+    G_io_apdu_buffer[3] = numItems;
+    *tx = 4;
+    THROW(APDU_CODE_OK);
+}
+
 // Handle Multisig, Vesting and Vault addresses
 __Z_INLINE void handleMultisig(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx, account_type_e account_type) {
     ZEMU_LOGF(50, "handleMultisig %d\n", rx);
-    if (!process_chunk(tx, rx)) {
+    if (!process_chunk(tx, rx, false)) {
         THROW(APDU_CODE_OK);
     }
 
@@ -296,6 +333,12 @@ void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
                     break;
                 }
 
+                case INS_VALIDATE_TX: {
+                    CHECK_PIN_VALIDATED()
+                    handleValidateTx(flags, tx, rx);
+                    break;
+                }
+
 #if defined(APP_TESTING)
                 case INS_TEST: {
                     handleTest(flags, tx, rx);
@@ -49,6 +49,7 @@ extern "C" {
 #define INS_GET_ADDR_VESTING 0x04
 #define INS_GET_ADDR_VAULT 0x05
 #define INS_SIGN_MESSAGE 0x06
+#define INS_VALIDATE_TX 0x07
 
 #define COIN_AMOUNT_DECIMAL_PLACES 9
 #define COIN_TICKER "SMH "
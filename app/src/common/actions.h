@@ -18,6 +18,7 @@
 #include <os_io_seproxyhal.h>
 #include <stdint.h>
 
+#include "addr.h"
 #include "apdu_codes.h"
 #include "coin.h"
 #include "crypto.h"
@@ -51,7 +52,7 @@ __Z_INLINE zxerr_t app_fill_address_multisig() {
     CHECK_ZXERR(crypto_fillAddressMultisigOrVesting(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE, &action_addrResponseLen));
 
     addr_request.account_type = MULTISIG;
-    return zxerr_ok;
+    return addr_prepareReview();
 }
 
 __Z_INLINE zxerr_t app_fill_address_vesting() {
@@ -61,7 +62,7 @@ __Z_INLINE zxerr_t app_fill_address_vesting() {
     CHECK_ZXERR(crypto_fillAddressMultisigOrVesting(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE, &action_addrResponseLen));
 
     addr_request.account_type = VESTING;
-    return zxerr_ok;
+    return addr_prepareReview();
 }
 
 __Z_INLINE zxerr_t app_fill_address_vault() {
@@ -71,7 +72,7 @@ __Z_INLINE zxerr_t app_fill_address_vault() {
     CHECK_ZXERR(crypto_fillAddressVault(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE, &action_addrResponseLen));
 
     addr_request.account_type = VAULT;
-    return zxerr_ok;
+    return addr_prepareReview();
 }
 
 __Z_INLINE void app_sign() {
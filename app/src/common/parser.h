@@ -30,16 +30,36 @@ const char *parser_getMsgPackTypeDescription(uint8_t type);
 //// parses a tx buffer
 parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data, size_t dataLen, parser_tx_t *tx_obj);
 
+//// attaches (and clears) the render cache used by parser_getItem
+void parser_attach_cache(parser_context_t *ctx, parser_display_cache_t *cache);
+
+//// hashes the ordered pubkeys of a multisig or vesting spawn, the key set digest of the compact review
+parser_error_t parser_keysetDigest(const parser_tx_t *tx_obj, uint8_t *digest, uint16_t digestLen);
+
 //// verifies tx fields
 parser_error_t parser_validate(parser_context_t *ctx);
 
 //// returns the number of items in the current parsing context
 parser_error_t parser_getNumItems(const parser_context_t *ctx, uint8_t *num_items);
 
+// The normal review shows the first numItems items of the expert review, rendered the same way. Both reviews can then
+// come out of a single pass over the items of a context with expert set.
+parser_error_t parser_getNumItemsBothModes(const parser_context_t *ctx, uint8_t *numItems, uint8_t *numItemsExpert);
+
+// Number of items of each method, see parser_methods.h
+parser_error_t getNumItemsSpend(const parser_context_t *ctx, uint8_t *numItems);
+parser_error_t getNumItemsDrain(const parser_context_t *ctx, uint8_t *numItems);
+parser_error_t getNumItemsWalletSpawn(const parser_context_t *ctx, uint8_t *numItems);
+parser_error_t getNumItemsMultisigSpawn(const parser_context_t *ctx, uint8_t *numItems);
+parser_error_t getNumItemsVaultSpawn(const parser_context_t *ctx, uint8_t *numItems);
+
 // retrieves a readable output for each field / page
 parser_error_t parser_getItem(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                               char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount);
 
+parser_error_t printCachedTxnFields(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
+                                    char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount);
+
 parser_error_t printTxnFields(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                               char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount);
 
@@ -55,8 +75,10 @@ parser_error_t printDrainTx(const parser_context_t *ctx, uint8_t displayIdx, cha
                             uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount);
 parser_error_t printNumber(uint64_t amount, uint8_t decimalPlaces, const char *postfix, const char *prefix, char *outValue,
                            uint16_t outValueLen, uint8_t pageIdx, uint8_t *pageCount);
-parser_error_t printAddress(const uint8_t *pubkey, char *outValue, uint16_t outValueLen, uint8_t pageIdx,
-                            uint8_t *pageCount);
+parser_error_t printBech32(const parser_context_t *ctx, const uint8_t *address, char *outValue, uint16_t outValueLen,
+                           uint8_t pageIdx, uint8_t *pageCount);
+parser_error_t printAddress(const parser_context_t *ctx, const uint8_t *pubkey, char *outValue, uint16_t outValueLen,
+                            uint8_t pageIdx, uint8_t *pageCount);
 
 #ifdef __cplusplus
 }
@@ -60,6 +60,12 @@ typedef enum {
     parser_tx_obj_empty,
 } parser_error_t;
 
+// Display flags, taken from P2 of the first sign packet
+#define DISPLAY_FLAG_COMPACT 0x01
+// Long binary messages are reviewed by their length and BLAKE3 digest instead of hex pages
+#define DISPLAY_FLAG_MESSAGE_DIGEST 0x02
+#define DISPLAY_FLAGS_KNOWN (DISPLAY_FLAG_COMPACT | DISPLAY_FLAG_MESSAGE_DIGEST)
+
 typedef struct {
     const uint8_t *buffer;
     uint16_t bufferLen;
@@ -68,6 +74,13 @@ typedef struct {
         parser_tx_t *tx_obj;
         parser_message_tx_t *message_tx_obj;
     };
+    // Optional, holds rendered items so paging does not run the formatters again
+    parser_display_cache_t *cache;
+    uint8_t displayFlags;
+    // Selects the address hrp, set by the caller after parsing
+    network_e network;
+    // Expert review, with the extra items appended after the normal ones. Also set by the caller.
+    bool expert;
 } parser_context_t;
 
 #ifdef __cplusplus
@@ -19,9 +19,11 @@
 #include <string.h>
 
 #include "apdu_codes.h"
+#include "app_mode.h"
 #include "buffering.h"
 #include "parser.h"
 #include "parser_message.h"
+#include "parser_state.h"
 #include "zxmacros.h"
 
 #if defined(TARGET_NANOX) || defined(TARGET_NANOS2) || defined(TARGET_STAX) || defined(TARGET_FLEX)
@@ -45,9 +47,13 @@ storage_t NV_CONST N_appdata_impl __attribute__((aligned(64)));
 #define N_appdata (*(NV_VOLATILE storage_t *)PIC(&N_appdata_impl))
 #endif
 
-static parser_tx_t tx_obj;
-static parser_message_tx_t message_tx_obj;
-static parser_context_t ctx_parsed_tx;
+// The tx or message being signed, or the review of an address request. Only one of them is reviewed at a time, so
+// they share one buffer.
+static union {
+    parser_state_t parser;
+    addr_review_t addr;
+} tx_review;
+static parser_message_digest_t message_digest;
 
 void tx_initialize() {
     buffering_init(ram_buffer, sizeof(ram_buffer), (uint8_t *)N_appdata.buffer, sizeof(N_appdata.buffer));
@@ -61,10 +67,9 @@ uint32_t tx_get_buffer_length() { return buffering_get_buffer()->pos; }
 
 uint8_t *tx_get_buffer() { return buffering_get_buffer()->data; }
 
-const char *tx_parse() {
-    MEMZERO(&tx_obj, sizeof(tx_obj));
-
-    parser_error_t err = parser_parse(&ctx_parsed_tx, tx_get_buffer(), tx_get_buffer_length(), &tx_obj);
+const char *tx_parse(uint8_t displayFlags) {
+    parser_error_t err = parser_state_parseTx(&tx_review.parser, tx_get_buffer(), tx_get_buffer_length(), displayFlags,
+                                              network_fromHdPath(), app_mode_expert());
 
     CHECK_APP_CANARY()
 
@@ -72,7 +77,7 @@ const char *tx_parse() {
         return parser_getErrorDescription(err);
     }
 
-    err = parser_validate(&ctx_parsed_tx);
+    err = parser_validate(&tx_review.parser.ctx);
     CHECK_APP_CANARY()
 
     if (err != parser_ok) {
@@ -82,9 +87,23 @@ const char *tx_parse() {
     return NULL;
 }
 
-const char *tx_message_parse() {
+uint8_t tx_validate(uint8_t displayFlags, uint16_t *errorOffset, uint8_t *numItems) {
     const parser_error_t err =
-        parser_message_parse(&ctx_parsed_tx, tx_get_buffer(), tx_get_buffer_length(), &message_tx_obj);
+        parser_state_validateTx(&tx_review.parser, tx_get_buffer(), tx_get_buffer_length(), displayFlags,
+                                network_fromHdPath(), app_mode_expert(), errorOffset, numItems);
+    CHECK_APP_CANARY()
+    return (uint8_t)err;
+}
+
+void tx_message_digest_init() { parser_message_digest_init(&message_digest); }
+
+void tx_message_digest_update(const uint8_t *chunk, uint16_t chunkLen) {
+    parser_message_digest_update(&message_digest, chunk, chunkLen);
+}
+
+const char *tx_message_parse(uint8_t displayFlags) {
+    const parser_error_t err =
+        parser_state_parseMessage(&tx_review.parser, tx_get_buffer(), tx_get_buffer_length(), displayFlags, &message_digest);
 
     CHECK_APP_CANARY()
 
@@ -94,10 +113,12 @@ const char *tx_message_parse() {
     return NULL;
 }
 
-void tx_parse_reset() { MEMZERO(&tx_obj, sizeof(tx_obj)); }
+addr_review_t *tx_addr_review() { return &tx_review.addr; }
+
+void tx_parse_reset() { parser_state_init(&tx_review.parser); }
 
 zxerr_t tx_getNumItems(uint8_t *num_items) {
-    parser_error_t err = parser_getNumItems(&ctx_parsed_tx, num_items);
+    parser_error_t err = parser_getNumItems(&tx_review.parser.ctx, num_items);
 
     if (err != parser_ok) {
         return zxerr_unknown;
@@ -117,7 +138,7 @@ zxerr_t tx_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char *ou
     }
 
     parser_error_t err =
-        parser_getItem(&ctx_parsed_tx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+        parser_getItem(&tx_review.parser.ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
 
     // Convert error codes
     if (err == parser_no_data || err == parser_display_idx_out_of_range || err == parser_display_page_out_of_range)
@@ -129,7 +150,7 @@ zxerr_t tx_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen, char *ou
 }
 
 zxerr_t tx_message_getNumItems(uint8_t *num_items) {
-    parser_error_t err = parser_message_getNumItems(num_items);
+    parser_error_t err = parser_message_getNumItems(&tx_review.parser.ctx, num_items);
 
     if (err != parser_ok) {
         return zxerr_unknown;
@@ -150,7 +171,7 @@ zxerr_t tx_message_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen,
     }
 
     parser_error_t err =
-        parser_message_getItem(&ctx_parsed_tx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+        parser_message_getItem(&tx_review.parser.ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
 
     // Convert error codes
     if (err == parser_no_data || err == parser_display_idx_out_of_range || err == parser_display_page_out_of_range)
@@ -15,6 +15,7 @@
  ********************************************************************************/
 #pragma once
 
+#include "addr.h"
 #include "coin.h"
 #include "os.h"
 #include "zxerror.h"
@@ -41,10 +42,27 @@ uint8_t *tx_get_buffer();
 
 /// Parse message stored in transaction buffer
 /// This function should be called as soon as full buffer data is loaded.
+/// \param displayFlags DISPLAY_FLAG_* bits selecting how the transaction is reviewed
 /// \return It returns NULL if data is valid or error message otherwise.
-const char *tx_parse();
+const char *tx_parse(uint8_t displayFlags);
 
-const char *tx_message_parse();
+/// Parse and validate the transaction buffer without keeping it for a review
+/// \param displayFlags DISPLAY_FLAG_* bits, as for tx_parse
+/// \param errorOffset where the parser stopped: the field that failed to parse, or the end of the transaction
+/// \param numItems number of review items, 0 unless the transaction is valid
+/// \return parser_error_t code, parser_ok if the transaction would be accepted by tx_parse
+uint8_t tx_validate(uint8_t displayFlags, uint16_t *errorOffset, uint8_t *numItems);
+
+/// Feed the message payload to the digest as its chunks arrive, see parser_message_digest_init
+void tx_message_digest_init();
+void tx_message_digest_update(const uint8_t *chunk, uint16_t chunkLen);
+
+/// \param displayFlags DISPLAY_FLAG_* bits selecting how the message is reviewed
+const char *tx_message_parse(uint8_t displayFlags);
+
+/// Review of the current address request. It shares its storage with the parsed transaction or message, which is
+/// never reviewed at the same time, and is overwritten by the next parse.
+addr_review_t *tx_addr_review();
 
 /// Return the number of items in the transaction
 zxerr_t tx_getNumItems(uint8_t *num_items);
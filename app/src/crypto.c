@@ -24,7 +24,7 @@
 
 extern address_request_t addr_request;
 
-void logAccount(generic_account_t *account, pubkey_item_t *internalPubkey);
+void logAccount(const generic_account_t *account, const pubkey_item_t *internalPubkey);
 
 zxerr_t crypto_extractPublicKey(uint8_t *pubKey, uint16_t pubKeyLen) {
     if (pubKey == NULL || pubKeyLen < PUB_KEY_LENGTH) {
@@ -117,7 +117,7 @@ zxerr_t crypto_fillAddress(uint8_t *outBuffer, uint16_t outBufferLen, uint16_t *
     uint8_t address_encoded[MAX_ADDRESS_LENGTH] = {0};
     CHECK_ZXERR(crypto_encodeAccountPubkey(address_encoded, sizeof(address_encoded), &internalPubkey, NULL, WALLET));
 
-    const char *hrp = calculate_hrp();
+    const char *hrp = calculate_hrp(network_fromHdPath());
     CHECK_ZXERR(bech32EncodeFromBytes(resp->address_bech32, sizeof(resp->address_bech32), hrp, address_encoded,
                                       ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
 
@@ -156,7 +156,7 @@ zxerr_t crypto_fillAddressMultisigOrVesting(uint8_t *outBuffer, uint16_t outBuff
                                            addr_request.account_type));
 
     // Copy internal pubkey in the buffer
-    const char *hrp = calculate_hrp();
+    const char *hrp = calculate_hrp(network_fromHdPath());
     MEMCPY(resp->pubkey, internalPubkey.pubkey, PUB_KEY_LENGTH);
     CHECK_ZXERR(bech32EncodeFromBytes(resp->address_bech32, 64, hrp, address, ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
 
@@ -188,12 +188,12 @@ zxerr_t crypto_fillAddressVault(uint8_t *outBuffer, uint16_t outBufferLen, uint1
     pubkey_item_t internalPubkey = {.pubkey = {0}, .index = addr_request.internalIndex};
     CHECK_ZXERR(crypto_extractPublicKey(internalPubkey.pubkey, sizeof(internalPubkey.pubkey)));
 
-    logAccount(&addr_request.vault_account->owner, &internalPubkey);
+    logAccount(addr_request.account, &internalPubkey);
 
     uint8_t address[MAX_ADDRESS_LENGTH] = {0};
-    CHECK_ZXERR(crypto_encodeVaultPubkey(address, sizeof(address), &internalPubkey, addr_request.vault_account));
+    CHECK_ZXERR(crypto_encodeVaultPubkey(address, sizeof(address), &internalPubkey, &addr_request.vault_account));
 
-    const char *hrp = calculate_hrp();
+    const char *hrp = calculate_hrp(network_fromHdPath());
     MEMCPY(resp->pubkey, internalPubkey.pubkey, PUB_KEY_LENGTH);
     CHECK_ZXERR(bech32EncodeFromBytes(resp->address_bech32, 64, hrp, address, ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
 
@@ -202,7 +202,7 @@ zxerr_t crypto_fillAddressVault(uint8_t *outBuffer, uint16_t outBufferLen, uint1
     return zxerr_ok;
 }
 
-void logAccount(generic_account_t *account, pubkey_item_t *internalPubkey) {
+void logAccount(const generic_account_t *account, const pubkey_item_t *internalPubkey) {
 #ifndef APP_TESTING
     (void)account;
     (void)internalPubkey;
@@ -100,12 +100,102 @@ static uint16_t scaleEncodeUint64(uint64_t v, uint8_t *out) {
 }
 
 static zxerr_t updateScaleEncodedNumber(uint64_t num) {
-    uint8_t encNum[8] = {0};
+    // Big integer mode needs a prefix byte plus up to 8 value bytes
+    uint8_t encNum[1 + sizeof(uint64_t)] = {0};
     size_t size = scaleEncodeUint64(num, encNum);
     CHECK_PARSER_OK(zxblake3_hash_update(encNum, size));
     return zxerr_ok;
 }
 
+// Internal key index, approvers and participants
+#define ADDRESS_REQUEST_HEADER_LEN 3
+// totalAmount, initialUnlockAmount, vestingStart and vestingEnd
+#define ADDRESS_REQUEST_VAULT_TERMS_LEN 24
+
+static uint64_t readUint64LE(const uint8_t *in) {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < sizeof(uint64_t); i++) {
+        v |= (uint64_t)in[i] << (8u * i);
+    }
+    return v;
+}
+
+static uint32_t readUint32LE(const uint8_t *in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8u | (uint32_t)in[2] << 16u | (uint32_t)in[3] << 24u;
+}
+
+zxerr_t parseAddressRequest(const uint8_t *buffer, uint16_t bufferLen, account_type_e account_type,
+                            address_request_t *request) {
+    if (buffer == NULL || request == NULL) {
+        return zxerr_no_data;
+    }
+    MEMZERO(request, sizeof(*request));
+
+    // The account follows the internal index and, for VAULT, the terms
+    uint16_t headerLen = ADDRESS_REQUEST_HEADER_LEN;
+    uint16_t accountOffset = 1;
+    switch (account_type) {
+        case MULTISIG:
+        case VESTING:
+            break;
+        case VAULT:
+            headerLen += ADDRESS_REQUEST_VAULT_TERMS_LEN;
+            accountOffset += ADDRESS_REQUEST_VAULT_TERMS_LEN;
+            break;
+        default:
+            return zxerr_encoding_failed;
+    }
+
+    if (bufferLen < headerLen) {
+        return zxerr_invalid_crypto_settings;
+    }
+
+    // Ensure the buffer size is a multiple of pubkey_item_t
+    const uint16_t pubkeysBuffSize = bufferLen - headerLen;
+    if (pubkeysBuffSize % sizeof(pubkey_item_t) != 0) {
+        return zxerr_invalid_crypto_settings;
+    }
+
+    const generic_account_t *account = (const generic_account_t *)(buffer + accountOffset);
+
+    // Every participant but the device itself is sent
+    const uint16_t numberOfPubkeys = pubkeysBuffSize / sizeof(pubkey_item_t);
+    if (numberOfPubkeys >= MAX_MULTISIG_PUB_KEY || numberOfPubkeys + 1 != account->participants) {
+        return zxerr_invalid_crypto_settings;
+    }
+    if (account->approvers == 0 || account->approvers > account->participants) {
+        return zxerr_invalid_crypto_settings;
+    }
+
+    const uint8_t internalIndex = buffer[0];
+    if (internalIndex >= account->participants) {
+        return zxerr_invalid_crypto_settings;
+    }
+
+    // External keys must be sorted by index, skipping the internal one
+    for (uint8_t i = 0; i < numberOfPubkeys; i++) {
+        const uint8_t expectedIndex = i < internalIndex ? i : (uint8_t)(i + 1);
+        if (account->keys[i].index != expectedIndex) {
+            return zxerr_invalid_crypto_settings;
+        }
+    }
+
+    if (account_type == VAULT) {
+        const uint8_t *terms = buffer + 1;
+        request->vault_account.totalAmount = readUint64LE(terms);
+        request->vault_account.initialUnlockAmount = readUint64LE(terms + 8);
+        request->vault_account.vestingStart = readUint32LE(terms + 16);
+        request->vault_account.vestingEnd = readUint32LE(terms + 20);
+        request->vault_account.owner = account;
+    }
+
+    request->account = account;
+    request->internalIndex = internalIndex;
+    request->optional_numberOfPubkeys = (uint8_t)numberOfPubkeys;
+    request->account_type = account_type;
+    return zxerr_ok;
+}
+
 zxerr_t crypto_encodeWalletPubkey(uint8_t *address, uint16_t addressLen, const uint8_t *pubkey) {
     if (address == NULL || pubkey == NULL || addressLen < MAX_ADDRESS_LENGTH) {
         return zxerr_no_data;
@@ -179,7 +269,7 @@ zxerr_t crypto_encodeAccountPubkey(uint8_t *address, uint16_t addressLen, const
 
 zxerr_t crypto_encodeVaultPubkey(uint8_t *address, uint16_t addressLen, const pubkey_item_t *internalPubkey,
                                  const vault_account_t *vaultAccount) {
-    if (address == NULL || vaultAccount == NULL || addressLen < MAX_ADDRESS_LENGTH) {
+    if (address == NULL || vaultAccount == NULL || vaultAccount->owner == NULL || addressLen < MAX_ADDRESS_LENGTH) {
         return zxerr_no_data;
     }
 
@@ -188,8 +278,8 @@ zxerr_t crypto_encodeVaultPubkey(uint8_t *address, uint16_t addressLen, const pu
 
     // first get vesting address without bench32Encode and clean encode buffer
     uint8_t addressVesting[100] = {0};
-    CHECK_ZX_OK(
-        crypto_encodeAccountPubkey(addressVesting, sizeof(addressVesting), internalPubkey, &vaultAccount->owner, VESTING));
+    CHECK_ZX_OK(crypto_encodeAccountPubkey(addressVesting, sizeof(addressVesting), internalPubkey, vaultAccount->owner,
+                                           VESTING));
 
     CHECK_PARSER_OK(zxblake3_hash_init());
     CHECK_PARSER_OK(zxblake3_hash_update(template, sizeof(template)));
@@ -41,6 +41,12 @@ typedef enum {
     VAULT = 4,
 } account_type_e;
 
+typedef enum {
+    NETWORK_MAINNET = 0,
+    NETWORK_TESTNET = 1,
+} network_e;
+
+// Request wire layout. Every field is a byte, so these are read in place from any buffer offset.
 typedef struct {
     uint8_t index;
     uint8_t pubkey[32];
@@ -52,13 +58,14 @@ typedef struct {
     pubkey_item_t keys[MAX_MULTISIG_PUB_KEY];
 } __attribute__((packed)) generic_account_t;
 
+// Vault terms are little-endian on the wire and decoded into these native-aligned fields
 typedef struct {
     uint64_t totalAmount;
     uint64_t initialUnlockAmount;
     uint32_t vestingStart;
     uint32_t vestingEnd;
-    generic_account_t owner;
-} __attribute__((packed)) vault_account_t;
+    const generic_account_t *owner;
+} vault_account_t;
 
 ////////////
 
@@ -67,21 +74,31 @@ typedef struct {
     uint8_t internalIndex;
 
     uint8_t optional_numberOfPubkeys;
-    union {
-        generic_account_t *account;
-        vault_account_t *vault_account;
-    };
+    // Multisig, vesting or vault owner account, in the request buffer
+    const generic_account_t *account;
+    // VAULT only, its owner is account
+    vault_account_t vault_account;
 } address_request_t;
 
 /**
  * Calculate the human-readable part (hrp) for Bech32 encoding based on the network type.
  * @returns the appropriate hrp string for the network
  */
-__Z_INLINE const char *calculate_hrp() {
-    bool mainnet = hdPath[0] == HDPATH_0_DEFAULT && hdPath[1] == HDPATH_1_DEFAULT;
-    return mainnet ? "sm" : "stest";
+__Z_INLINE const char *calculate_hrp(network_e network) { return network == NETWORK_MAINNET ? "sm" : "stest"; }
+
+// Network of the path received with the current APDU
+__Z_INLINE network_e network_fromHdPath() {
+    const bool mainnet = hdPath[0] == HDPATH_0_DEFAULT && hdPath[1] == HDPATH_1_DEFAULT;
+    return mainnet ? NETWORK_MAINNET : NETWORK_TESTNET;
 }
 
+/**
+ * Decodes and validates an address request: internal key index, account header and the external pubkeys
+ * (plus the vault terms for VAULT, copied into request). request->account refers into buffer.
+ */
+zxerr_t parseAddressRequest(const uint8_t *buffer, uint16_t bufferLen, account_type_e account_type,
+                            address_request_t *request);
+
 zxerr_t crypto_encodeWalletPubkey(uint8_t *address, uint16_t addressLen, const uint8_t *pubkey);
 zxerr_t crypto_encodeAccountPubkey(uint8_t *address, uint16_t addressLen, const pubkey_item_t *internalPubkey,
                                    const generic_account_t *account, account_type_e id);
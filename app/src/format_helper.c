@@ -0,0 +1,166 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "format_helper.h"
+
+#include <string.h>
+#include <zxmacros.h>
+
+#define MAX_UINT64_DIGITS 20
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char HEX_LOWER[] = "0123456789abcdef";
+static const char HEX_UPPER[] = "0123456789ABCDEF";
+#define HEX_GROUP_SEPARATOR ' '
+
+// Writes the decimal digits of value at the end of digits, returns how many were written
+static uint8_t uint64ToDigits(char digits[MAX_UINT64_DIGITS], uint64_t value) {
+    const char *pairs = (const char *)PIC(DIGIT_PAIRS);
+    uint8_t pos = MAX_UINT64_DIGITS;
+
+    while (value >= 100) {
+        const uint8_t pair = (uint8_t)(value % 100);
+        value /= 100;
+        digits[--pos] = pairs[2 * pair + 1];
+        digits[--pos] = pairs[2 * pair];
+    }
+    if (value >= 10) {
+        digits[--pos] = pairs[2 * value + 1];
+        digits[--pos] = pairs[2 * value];
+    } else {
+        digits[--pos] = (char)('0' + value);
+    }
+
+    return MAX_UINT64_DIGITS - pos;
+}
+
+// Decimal digit of weight 10^-(idx + 1), taking the missing leading digits as zeros
+static char fractionalDigit(const char *number, uint8_t numDigits, uint8_t decimalPlaces, uint8_t idx) {
+    const int16_t pos = (int16_t)numDigits - (int16_t)decimalPlaces + (int16_t)idx;
+    return pos < 0 ? '0' : number[pos];
+}
+
+parser_error_t formatFixedPoint(char *out, uint16_t outLen, uint64_t amount, uint8_t decimalPlaces, const char *prefix,
+                                const char *postfix) {
+    if (out == NULL || outLen == 0 || prefix == NULL || postfix == NULL) {
+        return parser_unexpected_value;
+    }
+    MEMZERO(out, outLen);
+
+    char digits[MAX_UINT64_DIGITS];
+    const uint8_t numDigits = uint64ToDigits(digits, amount);
+    const char *number = digits + MAX_UINT64_DIGITS - numDigits;
+
+    // Integer part is "0" when every digit falls after the decimal point
+    const uint8_t intDigits = numDigits > decimalPlaces ? numDigits - decimalPlaces : 0;
+    const uint8_t intLen = intDigits > 0 ? intDigits : 1;
+
+    uint8_t fracLen = decimalPlaces;
+    while (fracLen > 1 && fractionalDigit(number, numDigits, decimalPlaces, fracLen - 1) == '0') {
+        fracLen--;
+    }
+
+    const size_t prefixLen = strlen(prefix);
+    const size_t postfixLen = strlen(postfix);
+    const size_t totalLen = prefixLen + intLen + (decimalPlaces > 0 ? 1 + fracLen : 0) + postfixLen;
+    if (totalLen >= outLen) {
+        return parser_unexpected_buffer_end;
+    }
+
+    char *p = out;
+    MEMCPY(p, prefix, prefixLen);
+    p += prefixLen;
+
+    if (intDigits > 0) {
+        MEMCPY(p, number, intDigits);
+        p += intDigits;
+    } else {
+        *p++ = '0';
+    }
+
+    if (decimalPlaces > 0) {
+        *p++ = '.';
+        for (uint8_t i = 0; i < fracLen; i++) {
+            *p++ = fractionalDigit(number, numDigits, decimalPlaces, i);
+        }
+    }
+
+    MEMCPY(p, postfix, postfixLen);
+    return parser_ok;
+}
+
+parser_error_t pageHexString(char *outVal, uint16_t outValLen, const uint8_t *in, uint16_t inLen, bool uppercase,
+                             uint8_t groupLen, uint8_t pageIdx, uint8_t *pageCount) {
+    MEMZERO(outVal, outValLen);
+    *pageCount = 0;
+
+    const uint16_t pageLen = outValLen - 1;
+    if (outValLen < 2 || in == NULL || inLen == 0) {
+        return parser_ok;
+    }
+
+    // Length of the whole rendered string, separators included
+    const uint32_t hexLen = (uint32_t)inLen * 2;
+    uint32_t renderedLen = hexLen;
+    if (groupLen > 0) {
+        renderedLen += (hexLen - 1) / groupLen;
+    }
+
+    // Pages past the 8-bit counter could never be reviewed, the value must not be shown truncated
+    const uint32_t pages = (renderedLen + pageLen - 1) / pageLen;
+    if (pages > UINT8_MAX) {
+        return parser_display_page_out_of_range;
+    }
+    *pageCount = (uint8_t)pages;
+    if (pageIdx >= *pageCount) {
+        return parser_ok;
+    }
+
+    const char *table = (const char *)PIC(uppercase ? HEX_UPPER : HEX_LOWER);
+    const uint32_t first = (uint32_t)pageIdx * pageLen;
+    const uint32_t last = first + pageLen < renderedLen ? first + pageLen : renderedLen;
+
+    if (groupLen == 0) {
+        // Characters map to nibbles one to one, keep the grouping division out of the common loop
+        for (uint32_t nibbleIdx = first; nibbleIdx < last; nibbleIdx++) {
+            const uint8_t byte = in[nibbleIdx / 2];
+            *outVal++ = table[(nibbleIdx % 2 == 0) ? (byte >> 4) : (byte & 0x0F)];
+        }
+        return parser_ok;
+    }
+
+    const uint32_t blockLen = (uint32_t)groupLen + 1;
+    for (uint32_t c = first; c < last; c++) {
+        if (c % blockLen == groupLen) {
+            *outVal++ = HEX_GROUP_SEPARATOR;
+            continue;
+        }
+        const uint32_t nibbleIdx = (c / blockLen) * groupLen + c % blockLen;
+        const uint8_t byte = in[nibbleIdx / 2];
+        *outVal++ = table[(nibbleIdx % 2 == 0) ? (byte >> 4) : (byte & 0x0F)];
+    }
+    return parser_ok;
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "parser_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Enough for a 20 digit uint64, the decimal point and the longest ticker
+#define FIXED_POINT_BUFFER_LEN 48
+
+// Writes prefix + fixed point representation of amount + postfix into out.
+// Trailing decimal zeros are trimmed, keeping at least one decimal digit.
+parser_error_t formatFixedPoint(char *out, uint16_t outLen, uint64_t amount, uint8_t decimalPlaces, const char *prefix,
+                                const char *postfix);
+
+// Same paging as pageStringHex, but only the characters of the requested page are encoded.
+// groupLen > 0 inserts a space every groupLen hex characters. Fails if the value needs more than UINT8_MAX pages.
+parser_error_t pageHexString(char *outVal, uint16_t outValLen, const uint8_t *in, uint16_t inLen, bool uppercase,
+                             uint8_t groupLen, uint8_t pageIdx, uint8_t *pageCount);
+
+#ifdef __cplusplus
+}
+#endif
@@ -17,15 +17,17 @@
 #include "parser.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <zxformat.h>
 #include <zxmacros.h>
 #include <zxtypes.h>
 
-#include "app_mode.h"
 #include "bech32.h"
 #include "coin.h"
+#include "format_helper.h"
 #include "parser_common.h"
 #include "parser_impl.h"
+#include "parser_methods.h"
 #include "zxblake3.h"
 
 #define CHECK_ZX_OK(CALL)                   \
@@ -44,6 +46,10 @@ parser_error_t parser_init_context(parser_context_t *ctx, const uint8_t *buffer,
     ctx->offset = 0;
     ctx->buffer = NULL;
     ctx->bufferLen = 0;
+    ctx->cache = NULL;
+    ctx->displayFlags = 0;
+    ctx->network = NETWORK_MAINNET;
+    ctx->expert = false;
 
     if (bufferSize == 0 || buffer == NULL) {
         // Not available, use defaults
@@ -61,6 +67,26 @@ parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data, size_t d
     return _read(ctx, tx_obj);
 }
 
+void parser_attach_cache(parser_context_t *ctx, parser_display_cache_t *cache) {
+    if (cache != NULL) {
+        MEMZERO(cache, sizeof(*cache));
+    }
+    ctx->cache = cache;
+}
+
+parser_error_t parser_keysetDigest(const parser_tx_t *tx_obj, uint8_t *digest, uint16_t digestLen) {
+    if (tx_obj == NULL || digest == NULL) {
+        return parser_unexpected_error;
+    }
+    // An empty key set is valid and hashes to the digest of no input
+    const uint16_t pubkeysLen = (uint16_t)(tx_obj->spawn.multisig.numberOfPubkeys * PUB_KEY_LENGTH);
+    CHECK_ERROR(zxblake3_hash_init());
+    if (pubkeysLen > 0) {
+        CHECK_ERROR(zxblake3_hash_update_stream(tx_multisigPubkey(tx_obj, 0), pubkeysLen));
+    }
+    return zxblake3_hash_finalize(digest, digestLen);
+}
+
 parser_error_t parser_validate(parser_context_t *ctx) {
     // Iterate through all items to check that all can be shown and are valid
     uint8_t numItems = 0;
@@ -83,47 +109,11 @@ parser_error_t parser_getNumItems(const parser_context_t *ctx, uint8_t *num_item
         return parser_tx_obj_empty;
     }
 
-    switch (ctx->tx_obj->methodSelector) {
-        case METHOD_SPAWN:
-            switch (ctx->tx_obj->account_type) {
-                case WALLET:
-                    *num_items = 3;
-                    if (app_mode_expert()) {
-                        *num_items = 7;
-                    }
-                    break;
-                case MULTISIG:
-                case VESTING:
-                    *num_items = 5 + MULTISIG_PRINT_FACTOR * ctx->tx_obj->spawn.multisig.numberOfPubkeys;
-                    if (app_mode_expert()) {
-                        *num_items = 9 + MULTISIG_PRINT_FACTOR * ctx->tx_obj->spawn.multisig.numberOfPubkeys;
-                    }
-                    break;
-                case VAULT:
-                    *num_items = 8;
-                    if (app_mode_expert()) {
-                        *num_items = 12;
-                    }
-                    break;
-                default:
-                    return parser_unexpected_value;
-            }
-            break;
-        case METHOD_SPEND:
-            *num_items = 5;
-            if (app_mode_expert()) {
-                *num_items = 8;
-            }
-            break;
-        case METHOD_DRAIN_VAULT:
-            *num_items = 6;
-            if (app_mode_expert()) {
-                *num_items = 9;
-            }
-            break;
-        default:
-            return parser_unexpected_value;
+    const parser_method_t *method = parser_getMethod(ctx->tx_obj->methodIdx);
+    if (method == NULL) {
+        return parser_unexpected_value;
     }
+    CHECK_ERROR(((parser_method_num_items_t)PIC(method->numItems))(ctx, num_items));
 
     if (*num_items == 0) {
         return parser_unexpected_number_items;
@@ -131,6 +121,49 @@ parser_error_t parser_getNumItems(const parser_context_t *ctx, uint8_t *num_item
     return parser_ok;
 }
 
+parser_error_t parser_getNumItemsBothModes(const parser_context_t *ctx, uint8_t *numItems, uint8_t *numItemsExpert) {
+    *numItems = 0;
+    *numItemsExpert = 0;
+
+    parser_context_t modeCtx = *ctx;
+    modeCtx.expert = false;
+    CHECK_ERROR(parser_getNumItems(&modeCtx, numItems));
+    modeCtx.expert = true;
+    CHECK_ERROR(parser_getNumItems(&modeCtx, numItemsExpert));
+    return parser_ok;
+}
+
+parser_error_t getNumItemsSpend(const parser_context_t *ctx, uint8_t *numItems) {
+    *numItems = ctx->expert ? 8 : 5;
+    return parser_ok;
+}
+
+parser_error_t getNumItemsDrain(const parser_context_t *ctx, uint8_t *numItems) {
+    *numItems = ctx->expert ? 9 : 6;
+    return parser_ok;
+}
+
+parser_error_t getNumItemsWalletSpawn(const parser_context_t *ctx, uint8_t *numItems) {
+    *numItems = ctx->expert ? 7 : 3;
+    return parser_ok;
+}
+
+parser_error_t getNumItemsMultisigSpawn(const parser_context_t *ctx, uint8_t *numItems) {
+    const uint8_t keyItems = (uint8_t)(MULTISIG_PRINT_FACTOR * ctx->tx_obj->spawn.multisig.numberOfPubkeys);
+    if (ctx->displayFlags & DISPLAY_FLAG_COMPACT) {
+        // Key set digest replaces the per-key items, which are only expanded in expert mode
+        *numItems = ctx->expert ? (uint8_t)(10 + keyItems) : 6;
+        return parser_ok;
+    }
+    *numItems = (uint8_t)((ctx->expert ? 9 : 5) + keyItems);
+    return parser_ok;
+}
+
+parser_error_t getNumItemsVaultSpawn(const parser_context_t *ctx, uint8_t *numItems) {
+    *numItems = ctx->expert ? 12 : 8;
+    return parser_ok;
+}
+
 static void cleanOutput(char *outKey, uint16_t outKeyLen, char *outVal, uint16_t outValLen) {
     MEMZERO(outKey, outKeyLen);
     MEMZERO(outVal, outValLen);
@@ -156,37 +189,72 @@ parser_error_t parser_getItem(const parser_context_t *ctx, uint8_t displayIdx, c
     CHECK_ERROR(checkSanity(numItems, displayIdx));
     cleanOutput(outKey, outKeyLen, outVal, outValLen);
 
-    return printTxnFields(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+    if (ctx->cache == NULL || outValLen < 2) {
+        return printTxnFields(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+    }
+    return printCachedTxnFields(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+}
+
+parser_error_t printCachedTxnFields(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
+                                    char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
+    parser_render_cache_t *cache = &ctx->cache->render;
+
+    // Items render the same in the normal and expert reviews, only their number differs. The compact review moves
+    // items and the network changes addresses, callers may set both after parsing.
+    if (!cache->valid || cache->displayIdx != displayIdx || cache->displayFlags != ctx->displayFlags ||
+        cache->network != ctx->network) {
+        MEMZERO(cache, sizeof(*cache));
+        uint8_t renderPageCount = 1;
+        CHECK_ERROR(printTxnFields(ctx, displayIdx, cache->key, sizeof(cache->key), cache->value, sizeof(cache->value), 0,
+                                   &renderPageCount));
+        if (renderPageCount > 1) {
+            // Too long to be kept, render this item directly
+            return printTxnFields(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+        }
+        cache->valueLen = strnlen(cache->value, sizeof(cache->value));
+        cache->displayIdx = displayIdx;
+        cache->displayFlags = ctx->displayFlags;
+        cache->network = ctx->network;
+        cache->valid = true;
+    }
+
+    snprintf(outKey, outKeyLen, "%s", cache->key);
+
+    // Page boundaries only depend on the page width, compute them once per item
+    const uint16_t pageLen = outValLen - 1;
+    if (cache->pageLen != pageLen) {
+        cache->pageLen = pageLen;
+        cache->pageCount = (uint8_t)((cache->valueLen + pageLen - 1) / pageLen);
+        if (cache->pageCount == 0) {
+            cache->pageCount = 1;
+        }
+    }
+
+    *pageCount = cache->pageCount;
+    if (pageIdx >= cache->pageCount) {
+        MEMZERO(outVal, outValLen);
+        return parser_ok;
+    }
+
+    const uint16_t pageOffset = (uint16_t)pageIdx * pageLen;
+    const uint16_t remaining = cache->valueLen - pageOffset;
+    MEMZERO(outVal, outValLen);
+    MEMCPY(outVal, cache->value + pageOffset, remaining < pageLen ? remaining : pageLen);
+    return parser_ok;
 }
 
 parser_error_t printTxnFields(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                               char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
-    switch (ctx->tx_obj->methodSelector) {
-        case METHOD_SPAWN:
-            switch (ctx->tx_obj->account_type) {
-                case WALLET:
-                    return printWalletSpawn(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-                case MULTISIG:
-                case VESTING:
-                    return printMultisigSpawn(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-                case VAULT:
-                    return printVaultSpawn(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-                default:
-                    return parser_unexpected_value;
-            }
-        case METHOD_SPEND:
-            return printSpendTx(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-        case METHOD_DRAIN_VAULT:
-            return printDrainTx(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-        default:
-            return parser_unexpected_value;
+    const parser_method_t *method = parser_getMethod(ctx->tx_obj->methodIdx);
+    if (method == NULL) {
+        return parser_unexpected_value;
     }
+    return ((parser_method_print_t)PIC(method->print))(ctx, displayIdx, outKey, outKeyLen, outVal, outValLen, pageIdx,
+                                                       pageCount);
 }
 
 parser_error_t printSpendTx(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen, char *outVal,
                             uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
-    char buff[64] = {0};
-    const char *hrp = calculate_hrp();
     switch (displayIdx) {
         case 0:
             snprintf(outKey, outKeyLen, "Tx type");
@@ -194,16 +262,10 @@ parser_error_t printSpendTx(const parser_context_t *ctx, uint8_t displayIdx, cha
             break;
         case 1:
             snprintf(outKey, outKeyLen, "Principal");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->principal.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_principal(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 2:
             snprintf(outKey, outKeyLen, "Destination");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->spend.destination.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_spendDestination(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 3:
             snprintf(outKey, outKeyLen, "Amount");
             return printNumber(ctx->tx_obj->spend.amount, COIN_AMOUNT_DECIMAL_PLACES, "", COIN_TICKER, outVal, outValLen,
@@ -219,7 +281,8 @@ parser_error_t printSpendTx(const parser_context_t *ctx, uint8_t displayIdx, cha
             return printNumber(ctx->tx_obj->methodSelector, 0, "", "", outVal, outValLen, pageIdx, pageCount);
         case 7:
             snprintf(outKey, outKeyLen, "Genesis Id");
-            pageStringHex(outVal, outValLen, (const char *)(ctx->tx_obj->genesisId.ptr), GENESIS_LENGTH, pageIdx, pageCount);
+            CHECK_ERROR(pageHexString(outVal, outValLen, tx_genesisId(ctx->tx_obj), GENESIS_LENGTH, false, 0, pageIdx,
+                                      pageCount));
             break;
         default:
             return parser_no_data;
@@ -230,8 +293,6 @@ parser_error_t printSpendTx(const parser_context_t *ctx, uint8_t displayIdx, cha
 
 parser_error_t printWalletSpawn(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                                 char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
-    char buff[64] = {0};
-    const char *hrp = calculate_hrp();
     switch (displayIdx) {
         case 0:
             snprintf(outKey, outKeyLen, "Tx type");
@@ -239,19 +300,13 @@ parser_error_t printWalletSpawn(const parser_context_t *ctx, uint8_t displayIdx,
             break;
         case 1:
             snprintf(outKey, outKeyLen, "Principal");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->principal.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_principal(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 2:
             snprintf(outKey, outKeyLen, "Gas price");
             return printNumber(ctx->tx_obj->gas_price, 0, "", COIN_BASIC_UNIT, outVal, outValLen, pageIdx, pageCount);
         case 3:
             snprintf(outKey, outKeyLen, "Template");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->spawn.account_template.ptr,
-                                              ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_accountTemplate(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 4:
             snprintf(outKey, outKeyLen, "Nonce");
             return printNumber(ctx->tx_obj->nonce, 0, "", "", outVal, outValLen, pageIdx, pageCount);
@@ -260,7 +315,8 @@ parser_error_t printWalletSpawn(const parser_context_t *ctx, uint8_t displayIdx,
             return printNumber(ctx->tx_obj->methodSelector, 0, "", "", outVal, outValLen, pageIdx, pageCount);
         case 6:
             snprintf(outKey, outKeyLen, "Genesis Id");
-            pageStringHex(outVal, outValLen, (const char *)(ctx->tx_obj->genesisId.ptr), GENESIS_LENGTH, pageIdx, pageCount);
+            CHECK_ERROR(pageHexString(outVal, outValLen, tx_genesisId(ctx->tx_obj), GENESIS_LENGTH, false, 0, pageIdx,
+                                      pageCount));
             break;
         default:
             return parser_no_data;
@@ -271,11 +327,27 @@ parser_error_t printWalletSpawn(const parser_context_t *ctx, uint8_t displayIdx,
 
 parser_error_t printMultisigSpawn(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                                   char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
-    char buff[64] = {0};
-    const char *hrp = calculate_hrp();
-    uint8_t adjustedIdx = displayIdx;
     const uint8_t pubkeysStart = 5;
 
+    // Compact review inserts the key set digest right before the per-key items
+    if (ctx->displayFlags & DISPLAY_FLAG_COMPACT) {
+        if (displayIdx == pubkeysStart) {
+            spawn_multisig_tx_t *multisig = &ctx->tx_obj->spawn.multisig;
+            if (!multisig->keysetDigestReady) {
+                CHECK_ERROR(parser_keysetDigest(ctx->tx_obj, multisig->keysetDigest, sizeof(multisig->keysetDigest)));
+                multisig->keysetDigestReady = true;
+            }
+            snprintf(outKey, outKeyLen, "Key set");
+            CHECK_ERROR(pageHexString(outVal, outValLen, multisig->keysetDigest, KEYSET_DIGEST_LEN, false, 0, pageIdx,
+                                      pageCount));
+            return parser_ok;
+        }
+        if (displayIdx > pubkeysStart) {
+            displayIdx--;
+        }
+    }
+
+    uint8_t adjustedIdx = displayIdx;
     if (displayIdx >= pubkeysStart &&
         displayIdx < pubkeysStart + MULTISIG_PRINT_FACTOR * ctx->tx_obj->spawn.multisig.numberOfPubkeys) {
         adjustedIdx = pubkeysStart;
@@ -294,10 +366,7 @@ parser_error_t printMultisigSpawn(const parser_context_t *ctx, uint8_t displayId
             break;
         case 1:
             snprintf(outKey, outKeyLen, "Principal");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->principal.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_principal(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 2:
             snprintf(outKey, outKeyLen, "Gas price");
             return printNumber(ctx->tx_obj->gas_price, 0, "", COIN_BASIC_UNIT, outVal, outValLen, pageIdx, pageCount);
@@ -317,21 +386,18 @@ parser_error_t printMultisigSpawn(const parser_context_t *ctx, uint8_t displayId
             }
             if (tmpDisplayIdx % 2 == 0) {
                 snprintf(outKey, outKeyLen, "Pubkey %d", pubkeyIdx);
-                pageStringHex(outVal, outValLen, (const char *)(ctx->tx_obj->spawn.multisig.pubkey[pubkeyIdx].ptr),
-                              PUB_KEY_LENGTH, pageIdx, pageCount);
+                CHECK_ERROR(pageHexString(outVal, outValLen, tx_multisigPubkey(ctx->tx_obj, pubkeyIdx), PUB_KEY_LENGTH,
+                                          false, 0, pageIdx, pageCount));
             } else {
                 snprintf(outKey, outKeyLen, "Address %d", pubkeyIdx);
-                return printAddress(ctx->tx_obj->spawn.multisig.pubkey[pubkeyIdx].ptr, outVal, outValLen, pageIdx,
+                return printAddress(ctx, tx_multisigPubkey(ctx->tx_obj, pubkeyIdx), outVal, outValLen, pageIdx,
                                     pageCount);
             }
             break;
         }
         case 6:
             snprintf(outKey, outKeyLen, "Template");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->spawn.account_template.ptr,
-                                              ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_accountTemplate(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
 
         case 7:
             snprintf(outKey, outKeyLen, "Nonce");
@@ -341,7 +407,8 @@ parser_error_t printMultisigSpawn(const parser_context_t *ctx, uint8_t displayId
             return printNumber(ctx->tx_obj->methodSelector, 0, "", "", outVal, outValLen, pageIdx, pageCount);
         case 9:
             snprintf(outKey, outKeyLen, "Genesis Id");
-            pageStringHex(outVal, outValLen, (const char *)(ctx->tx_obj->genesisId.ptr), GENESIS_LENGTH, pageIdx, pageCount);
+            CHECK_ERROR(pageHexString(outVal, outValLen, tx_genesisId(ctx->tx_obj), GENESIS_LENGTH, false, 0, pageIdx,
+                                      pageCount));
             break;
         default:
             return parser_no_data;
@@ -352,8 +419,6 @@ parser_error_t printMultisigSpawn(const parser_context_t *ctx, uint8_t displayId
 
 parser_error_t printVaultSpawn(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                                char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
-    char buff[64] = {0};
-    const char *hrp = calculate_hrp();
     switch (displayIdx) {
         case 0:
             snprintf(outKey, outKeyLen, "Tx type");
@@ -361,19 +426,13 @@ parser_error_t printVaultSpawn(const parser_context_t *ctx, uint8_t displayIdx,
             break;
         case 1:
             snprintf(outKey, outKeyLen, "Principal");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->principal.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_principal(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 2:
             snprintf(outKey, outKeyLen, "Gas price");
             return printNumber(ctx->tx_obj->gas_price, 0, "", COIN_BASIC_UNIT, outVal, outValLen, pageIdx, pageCount);
         case 3:
             snprintf(outKey, outKeyLen, "Owner");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->spawn.vault.owner.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_vaultOwner(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 4:
             // TODO: should we show decimals? same for cases 7, 8 and 9
             snprintf(outKey, outKeyLen, "TotalAmount");
@@ -393,10 +452,7 @@ parser_error_t printVaultSpawn(const parser_context_t *ctx, uint8_t displayIdx,
                                pageCount);
         case 8:
             snprintf(outKey, outKeyLen, "Template");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->spawn.account_template.ptr,
-                                              ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_accountTemplate(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 9:
             snprintf(outKey, outKeyLen, "Nonce");
             return printNumber(ctx->tx_obj->nonce, 0, "", "", outVal, outValLen, pageIdx, pageCount);
@@ -405,7 +461,8 @@ parser_error_t printVaultSpawn(const parser_context_t *ctx, uint8_t displayIdx,
             return printNumber(ctx->tx_obj->methodSelector, 0, "", "", outVal, outValLen, pageIdx, pageCount);
         case 11:
             snprintf(outKey, outKeyLen, "Genesis Id");
-            pageStringHex(outVal, outValLen, (const char *)(ctx->tx_obj->genesisId.ptr), GENESIS_LENGTH, pageIdx, pageCount);
+            CHECK_ERROR(pageHexString(outVal, outValLen, tx_genesisId(ctx->tx_obj), GENESIS_LENGTH, false, 0, pageIdx,
+                                      pageCount));
             break;
         default:
             return parser_no_data;
@@ -416,8 +473,6 @@ parser_error_t printVaultSpawn(const parser_context_t *ctx, uint8_t displayIdx,
 
 parser_error_t printDrainTx(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen, char *outVal,
                             uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount) {
-    char buff[64] = {0};
-    const char *hrp = calculate_hrp();
     switch (displayIdx) {
         case 0:
             snprintf(outKey, outKeyLen, "Tx type");
@@ -425,22 +480,13 @@ parser_error_t printDrainTx(const parser_context_t *ctx, uint8_t displayIdx, cha
             break;
         case 1:
             snprintf(outKey, outKeyLen, "Principal");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->principal.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_principal(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 2:
             snprintf(outKey, outKeyLen, "Vault");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->drain.vault.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_drainVault(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
         case 3:
             snprintf(outKey, outKeyLen, "Destination");
-            CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), hrp, ctx->tx_obj->drain.destination.ptr, ADDRESS_LENGTH, 1,
-                                              BECH32_ENCODING_BECH32));
-            pageString(outVal, outValLen, buff, pageIdx, pageCount);
-            break;
+            return printBech32(ctx, tx_drainDestination(ctx->tx_obj), outVal, outValLen, pageIdx, pageCount);
 
         case 4:
             snprintf(outKey, outKeyLen, "Amount");
@@ -458,7 +504,8 @@ parser_error_t printDrainTx(const parser_context_t *ctx, uint8_t displayIdx, cha
             break;
         case 8:
             snprintf(outKey, outKeyLen, "Genesis Id");
-            pageStringHex(outVal, outValLen, (const char *)(ctx->tx_obj->genesisId.ptr), GENESIS_LENGTH, pageIdx, pageCount);
+            CHECK_ERROR(pageHexString(outVal, outValLen, tx_genesisId(ctx->tx_obj), GENESIS_LENGTH, false, 0, pageIdx,
+                                      pageCount));
             break;
         default:
             return parser_no_data;
@@ -469,34 +516,91 @@ parser_error_t printDrainTx(const parser_context_t *ctx, uint8_t displayIdx, cha
 
 parser_error_t printNumber(uint64_t amount, uint8_t decimalPlaces, const char *postfix, const char *prefix, char *outValue,
                            uint16_t outValueLen, uint8_t pageIdx, uint8_t *pageCount) {
-    char bufferUI[200] = {0};
-    if (uint64_to_str(bufferUI, sizeof(bufferUI), amount) != NULL) {
-        return parser_unexpected_value;
+    char bufferUI[FIXED_POINT_BUFFER_LEN] = {0};
+    CHECK_ERROR(formatFixedPoint(bufferUI, sizeof(bufferUI), amount, decimalPlaces, prefix, postfix));
+
+    pageString(outValue, outValueLen, bufferUI, pageIdx, pageCount);
+    return parser_ok;
+}
+
+// The encodings carry the hrp of the network, a memo filled for another network is dropped
+static parser_address_memo_t *addressMemo(const parser_context_t *ctx) {
+    if (ctx->cache == NULL) {
+        return NULL;
     }
+    parser_address_memo_t *memo = &ctx->cache->addresses;
+    if (memo->network != ctx->network) {
+        MEMZERO(memo, sizeof(*memo));
+        memo->network = ctx->network;
+    }
+    return memo;
+}
 
-    if (intstr_to_fpstr_inplace(bufferUI, sizeof(bufferUI), decimalPlaces) == 0) {
-        return parser_unexpected_value;
+static const char *lookupAddressMemo(const parser_context_t *ctx, const uint8_t *key, uint8_t keyLen) {
+    parser_address_memo_t *memo = addressMemo(ctx);
+    if (memo == NULL) {
+        return NULL;
     }
+    for (uint8_t i = 0; i < ADDRESS_MEMO_ENTRIES; i++) {
+        if (memo->entries[i].keyLen == keyLen && MEMCMP(memo->entries[i].key, key, keyLen) == 0) {
+            // Move the hit to the front, so paging back and forth between items keeps their addresses
+            if (i > 0) {
+                const address_memo_entry_t hit = memo->entries[i];
+                MEMMOVE(&memo->entries[1], &memo->entries[0], i * sizeof(address_memo_entry_t));
+                memo->entries[0] = hit;
+            }
+            return memo->entries[0].encoded;
+        }
+    }
+    return NULL;
+}
 
-    if (z_str3join(bufferUI, sizeof(bufferUI), prefix, postfix) != zxerr_ok) {
-        return parser_unexpected_buffer_end;
+static void storeAddressMemo(const parser_context_t *ctx, const uint8_t *key, uint8_t keyLen, const char *encoded) {
+    parser_address_memo_t *memo = addressMemo(ctx);
+    if (memo == NULL || keyLen > PUB_KEY_LENGTH || strnlen(encoded, ADDRESS_MEMO_ENCODED_LEN) >= ADDRESS_MEMO_ENCODED_LEN) {
+        return;
     }
+    // The least recently used entry is dropped
+    MEMMOVE(&memo->entries[1], &memo->entries[0], (ADDRESS_MEMO_ENTRIES - 1) * sizeof(address_memo_entry_t));
 
-    number_inplace_trimming(bufferUI, 1);
+    address_memo_entry_t *entry = &memo->entries[0];
+    MEMCPY(entry->key, key, keyLen);
+    entry->keyLen = keyLen;
+    snprintf(entry->encoded, sizeof(entry->encoded), "%s", encoded);
+}
 
-    pageString(outValue, outValueLen, bufferUI, pageIdx, pageCount);
+parser_error_t printBech32(const parser_context_t *ctx, const uint8_t *address, char *outValue, uint16_t outValueLen,
+                           uint8_t pageIdx, uint8_t *pageCount) {
+    const char *memoized = lookupAddressMemo(ctx, address, ADDRESS_LENGTH);
+    if (memoized != NULL) {
+        pageString(outValue, outValueLen, memoized, pageIdx, pageCount);
+        return parser_ok;
+    }
+
+    char buff[64] = {0};
+    CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), calculate_hrp(ctx->network), address, ADDRESS_LENGTH, 1,
+                                      BECH32_ENCODING_BECH32));
+    storeAddressMemo(ctx, address, ADDRESS_LENGTH, buff);
+    pageString(outValue, outValueLen, buff, pageIdx, pageCount);
     return parser_ok;
 }
 
-parser_error_t printAddress(const uint8_t *pubkey, char *outValue, uint16_t outValueLen, uint8_t pageIdx,
-                            uint8_t *pageCount) {
-    char address[64] = {0};
-    const uint8_t pubkey_encoded[64] = {0};
-    const char *hrp = calculate_hrp();
+parser_error_t printAddress(const parser_context_t *ctx, const uint8_t *pubkey, char *outValue, uint16_t outValueLen,
+                            uint8_t pageIdx, uint8_t *pageCount) {
+    // Looked up by pubkey, so a revisited item skips the BLAKE3 derivation as well as the encoding
+    const char *memoized = lookupAddressMemo(ctx, pubkey, PUB_KEY_LENGTH);
+    if (memoized != NULL) {
+        pageString(outValue, outValueLen, memoized, pageIdx, pageCount);
+        return parser_ok;
+    }
+
+    uint8_t pubkey_encoded[64] = {0};
+    CHECK_ZX_OK(crypto_encodeWalletPubkey(pubkey_encoded, sizeof(pubkey_encoded), pubkey));
 
-    CHECK_ZX_OK(crypto_encodeWalletPubkey((uint8_t *)pubkey_encoded, sizeof(pubkey_encoded), pubkey));
-    CHECK_ZX_OK(
-        bech32EncodeFromBytes(address, sizeof(address), hrp, pubkey_encoded, ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32));
-    pageString(outValue, outValueLen, address, pageIdx, pageCount);
+    char buff[64] = {0};
+    CHECK_ZX_OK(bech32EncodeFromBytes(buff, sizeof(buff), calculate_hrp(ctx->network), pubkey_encoded, ADDRESS_LENGTH, 1,
+                                      BECH32_ENCODING_BECH32));
+    storeAddressMemo(ctx, pubkey, PUB_KEY_LENGTH, buff);
+    pageString(outValue, outValueLen, buff, pageIdx, pageCount);
     return parser_ok;
 }
@@ -17,6 +17,7 @@
 #include "parser_impl.h"
 
 #include "crypto_helper.h"
+#include "parser_methods.h"
 #include "scale_helper.h"
 #include "zxerror.h"
 
@@ -25,23 +26,16 @@ parser_error_t _read(parser_context_t *c, parser_tx_t *v) {
     if (c == NULL || v == NULL) {
         return parser_unexpected_error;
     }
-    CHECK_ERROR(readFixedArray(c, &v->genesisId, GENESIS_LENGTH));
+    v->buffer = c->buffer;
+    CHECK_ERROR(readFixedOffset(c, &v->genesisId, GENESIS_LENGTH));
     CHECK_ERROR(_readTxVersion(c, &v->tx_version));
-    CHECK_ERROR(readFixedArray(c, &v->principal, ADDRESS_LENGTH));
+    CHECK_ERROR(readFixedOffset(c, &v->principal, ADDRESS_LENGTH));
     CHECK_ERROR(_readMethodSelector(c, &v->methodSelector));
-    switch (v->methodSelector) {
-        case METHOD_SPAWN:
-            CHECK_ERROR(_readSpawnTx(c, v));
-            break;
-        case METHOD_SPEND:
-            CHECK_ERROR(_readSpendTx(c, v));
-            break;
-        case METHOD_DRAIN_VAULT:
-            CHECK_ERROR(_readDrainTx(c, v));
-            break;
-        default:
-            return parser_unexpected_value;
-    }
+
+    CHECK_ERROR(parser_findMethod(c, v));
+    const parser_method_t *method = parser_getMethod(v->methodIdx);
+    v->account_type = (account_type_e)method->templateType;
+    CHECK_ERROR(((parser_method_read_t)PIC(method->read))(c, v));
 
     if (c->offset != c->bufferLen) {
         return parser_unexpected_unparsed_bytes;
@@ -74,7 +74,9 @@ parser_error_t _getValue(const CompactInt_t *compact, uint64_t *value);
 
 parser_error_t _readTxVersion(parser_context_t *ctx, uint8_t *val);
 parser_error_t _readMethodSelector(parser_context_t *ctx, uint8_t *val);
-parser_error_t _readSpawnTx(parser_context_t *ctx, parser_tx_t *val);
+parser_error_t _readWalletSpawnTx(parser_context_t *ctx, parser_tx_t *val);
+parser_error_t _readMultisigSpawnTx(parser_context_t *ctx, parser_tx_t *val);
+parser_error_t _readVaultSpawnTx(parser_context_t *ctx, parser_tx_t *val);
 parser_error_t _readSpendTx(parser_context_t *ctx, parser_tx_t *val);
 parser_error_t _readDrainTx(parser_context_t *ctx, parser_tx_t *val);
 
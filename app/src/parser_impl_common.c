@@ -16,6 +16,7 @@
 
 #include "crypto_helper.h"
 #include "parser_impl.h"
+#include "parser_methods.h"
 #include "parser_txdef.h"
 #include "scale_helper.h"
 
@@ -76,7 +77,7 @@ parser_error_t _getValue(const CompactInt_t *compact, uint64_t *value) {
             *value += *(compact->ptr + 1) << 6U;
             *value += *(compact->ptr + 2) << (8U + 6U);
             *value += *(compact->ptr + 3) << (16U + 6U);
-            if (*value < 16383U) {
+            if (*value < 16384U) {
                 return parser_value_out_of_range;
             }
             break;
@@ -93,6 +94,10 @@ parser_error_t _getValue(const CompactInt_t *compact, uint64_t *value) {
             }
             *value |= compact->ptr[1] & 0xFF;
 
+            // Canonical encoding only: values that fit 4-byte mode and zero-padded lengths are rejected
+            if (*value < (1ULL << 30U) || compact->ptr[byte_length] == 0) {
+                return parser_value_out_of_range;
+            }
             if (*value > 4611686018427387903) {
                 return parser_value_out_of_range;
             }
@@ -105,65 +110,65 @@ parser_error_t _getValue(const CompactInt_t *compact, uint64_t *value) {
 parser_error_t _readTxVersion(parser_context_t *ctx, uint8_t *val) {
     CHECK_INPUT();
     CHECK_ERROR(readCompactU8(ctx, val));
-    if (*val != TX_VERSION) {
+    if (!parser_txVersionSupported(*val)) {
         return parser_unexpected_version;
     }
     return parser_ok;
 }
 
+// Checked against the method registry by parser_findMethod
 parser_error_t _readMethodSelector(parser_context_t *ctx, uint8_t *val) {
     CHECK_INPUT();
     CHECK_ERROR(readCompactU8(ctx, val));
-    if (*val != METHOD_SPAWN && *val != METHOD_SPEND && *val != METHOD_DRAIN_VAULT) {
-        return parser_unexpected_method_selector;
-    }
     return parser_ok;
 }
 
-parser_error_t _readSpawnTx(parser_context_t *ctx, parser_tx_t *val) {
+// Template, nonce and gas price shared by every spawn
+static parser_error_t _readSpawnHeader(parser_context_t *ctx, parser_tx_t *val) {
     CHECK_INPUT();
-    CHECK_ERROR(readFixedArray(ctx, &val->spawn.account_template, ADDRESS_LENGTH));
+    CHECK_ERROR(readFixedOffset(ctx, &val->spawn.account_template, ADDRESS_LENGTH));
     CHECK_ERROR(readCompactU64(ctx, &val->nonce));
     CHECK_ERROR(readCompactU64(ctx, &val->gas_price));
-    uint8_t accountType = val->spawn.account_template.ptr[val->spawn.account_template.len - 1];
-    switch (accountType) {
-        case WALLET:
-            val->account_type = WALLET;
-            CHECK_ERROR(readFixedArray(ctx, &val->spawn.wallet.pubkey, PUB_KEY_LENGTH));
-            break;
-        case MULTISIG:
-        case VESTING:
-            val->account_type = MULTISIG;
-            if (accountType == VESTING) {
-                val->account_type = VESTING;
-            }
-            CHECK_ERROR(readCompactU8(ctx, &val->spawn.multisig.approvers));
-            if (val->spawn.multisig.approvers > MAX_MULTISIG_PUB_KEY) {
-                return parser_unexpected_value;
-            }
-            CHECK_ERROR(readCompactU8(ctx, &val->spawn.multisig.numberOfPubkeys));
-            if (val->spawn.multisig.numberOfPubkeys < val->spawn.multisig.approvers ||
-                val->spawn.multisig.numberOfPubkeys > MAX_MULTISIG_PUB_KEY) {
-                return parser_unexpected_value;
-            }
-            for (uint8_t i = 0; i < val->spawn.multisig.numberOfPubkeys; i++) {
-                CHECK_ERROR(readFixedArray(ctx, &val->spawn.multisig.pubkey[i], PUB_KEY_LENGTH));
-            }
-            break;
-        case VAULT:
-            val->account_type = VAULT;
-            CHECK_ERROR(readFixedArray(ctx, &val->spawn.vault.owner, ADDRESS_LENGTH));
-            CHECK_ERROR(readCompactU64(ctx, &val->spawn.vault.totalAmount));
-            CHECK_ERROR(readCompactU64(ctx, &val->spawn.vault.initialUnlockAmount));
-            if (val->spawn.vault.initialUnlockAmount > val->spawn.vault.totalAmount) {
-                return parser_unexpected_value;
-            }
-            CHECK_ERROR(readCompactU32(ctx, &val->spawn.vault.vestingStart));
-            CHECK_ERROR(readCompactU32(ctx, &val->spawn.vault.vestingEnd));
-            if (val->spawn.vault.vestingStart > val->spawn.vault.vestingEnd) {
-                return parser_unexpected_value;
-            }
-            break;
+    return parser_ok;
+}
+
+parser_error_t _readWalletSpawnTx(parser_context_t *ctx, parser_tx_t *val) {
+    CHECK_ERROR(_readSpawnHeader(ctx, val));
+    CHECK_ERROR(readFixedOffset(ctx, &val->spawn.wallet.pubkey, PUB_KEY_LENGTH));
+    return parser_ok;
+}
+
+// Multisig and vesting spawns
+parser_error_t _readMultisigSpawnTx(parser_context_t *ctx, parser_tx_t *val) {
+    CHECK_ERROR(_readSpawnHeader(ctx, val));
+    CHECK_ERROR(readCompactU8(ctx, &val->spawn.multisig.approvers));
+    if (val->spawn.multisig.approvers > MAX_MULTISIG_PUB_KEY) {
+        return parser_unexpected_value;
+    }
+    CHECK_ERROR(readCompactU8(ctx, &val->spawn.multisig.numberOfPubkeys));
+    if (val->spawn.multisig.numberOfPubkeys < val->spawn.multisig.approvers ||
+        val->spawn.multisig.numberOfPubkeys > MAX_MULTISIG_PUB_KEY) {
+        return parser_unexpected_value;
+    }
+    // Pubkeys are contiguous. The key set digest is only hashed when the compact review shows it.
+    val->spawn.multisig.pubkeys = ctx->offset;
+    val->spawn.multisig.keysetDigestReady = false;
+    CTX_CHECK_AND_ADVANCE(ctx, (uint16_t)(val->spawn.multisig.numberOfPubkeys * PUB_KEY_LENGTH));
+    return parser_ok;
+}
+
+parser_error_t _readVaultSpawnTx(parser_context_t *ctx, parser_tx_t *val) {
+    CHECK_ERROR(_readSpawnHeader(ctx, val));
+    CHECK_ERROR(readFixedOffset(ctx, &val->spawn.vault.owner, ADDRESS_LENGTH));
+    CHECK_ERROR(readCompactU64(ctx, &val->spawn.vault.totalAmount));
+    CHECK_ERROR(readCompactU64(ctx, &val->spawn.vault.initialUnlockAmount));
+    if (val->spawn.vault.initialUnlockAmount > val->spawn.vault.totalAmount) {
+        return parser_unexpected_value;
+    }
+    CHECK_ERROR(readCompactU32(ctx, &val->spawn.vault.vestingStart));
+    CHECK_ERROR(readCompactU32(ctx, &val->spawn.vault.vestingEnd));
+    if (val->spawn.vault.vestingStart > val->spawn.vault.vestingEnd) {
+        return parser_unexpected_value;
     }
     return parser_ok;
 }
@@ -172,7 +177,7 @@ parser_error_t _readSpendTx(parser_context_t *ctx, parser_tx_t *val) {
     CHECK_INPUT();
     CHECK_ERROR(readCompactU64(ctx, &val->nonce));
     CHECK_ERROR(readCompactU64(ctx, &val->gas_price));
-    CHECK_ERROR(readFixedArray(ctx, &val->spend.destination, ADDRESS_LENGTH));
+    CHECK_ERROR(readFixedOffset(ctx, &val->spend.destination, ADDRESS_LENGTH));
     CHECK_ERROR(readCompactU64(ctx, &val->spend.amount));
     return parser_ok;
 }
@@ -181,8 +186,8 @@ parser_error_t _readDrainTx(parser_context_t *ctx, parser_tx_t *val) {
     CHECK_INPUT();
     CHECK_ERROR(readCompactU64(ctx, &val->nonce));
     CHECK_ERROR(readCompactU64(ctx, &val->gas_price));
-    CHECK_ERROR(readFixedArray(ctx, &val->drain.vault, ADDRESS_LENGTH));
-    CHECK_ERROR(readFixedArray(ctx, &val->drain.destination, ADDRESS_LENGTH));
+    CHECK_ERROR(readFixedOffset(ctx, &val->drain.vault, ADDRESS_LENGTH));
+    CHECK_ERROR(readFixedOffset(ctx, &val->drain.destination, ADDRESS_LENGTH));
     CHECK_ERROR(readCompactU64(ctx, &val->drain.amount));
     return parser_ok;
 }
@@ -18,14 +18,63 @@
 #include <stdio.h>
 #include <zxformat.h>
 
+#include "format_helper.h"
 #include "scale_helper.h"
+#include "zxblake3.h"
 
 GEN_DEF_READFIX_UNSIGNED(8)
 GEN_DEF_READFIX_UNSIGNED(16)
 
-static parser_error_t _formatOutput(const char *label, uint16_t len, const uint8_t *message, char *outKey,
-                                    uint16_t outKeyLen, char *outVal, uint16_t outValLen, uint8_t pageIdx,
-                                    uint8_t *pageCount) {
+// Long fields are split into several review items, so the page counter of each item stays in range
+#define MESSAGE_DISPLAY_WINDOW_LEN 1024
+
+// Binary messages longer than this are reviewed by their digest, their hex would take too many pages
+#define MESSAGE_HEX_MAX_LEN 128
+
+// Prefix, then the domain byte before the message
+#define MESSAGE_DOMAIN_LEN 1
+
+static bool _allPrintableBytes(const uint8_t *data, uint16_t len) {
+    bool allPrintable = true;
+    for (uint16_t i = 0; i < len; i++) {
+        allPrintable &= IS_PRINTABLE(data[i]);
+    }
+    return allPrintable;
+}
+
+#if defined(TARGET_NANOS) || defined(TARGET_NANOX) || defined(TARGET_NANOS2) || defined(TARGET_STAX) || defined(TARGET_FLEX)
+static bool _allPrintable(const uint8_t *data, uint16_t len) { return _allPrintableBytes(data, len); }
+#else
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGHS 0x8080808080808080ULL
+
+// Host parsers check eight bytes at a time. A word with any byte outside 0x20..0x7e is rechecked byte by byte, so the
+// result matches IS_PRINTABLE exactly.
+static bool _allPrintable(const uint8_t *data, uint16_t len) {
+    uint16_t i = 0;
+    for (; (size_t)i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        MEMCPY(&word, data + i, sizeof(word));
+        const uint64_t below = (word - SWAR_ONES * 0x20) & ~word & SWAR_HIGHS;
+        const uint64_t above = ((word + SWAR_ONES * (0x7f - 0x7e)) | word) & SWAR_HIGHS;
+        if ((below | above) != 0 && !_allPrintableBytes(data + i, sizeof(uint64_t))) {
+            return false;
+        }
+    }
+    return _allPrintableBytes(data + i, len - i);
+}
+#endif
+
+static uint8_t _windowCount(uint16_t len) {
+    if (len == 0) {
+        return 1;
+    }
+    return (uint8_t)((len + MESSAGE_DISPLAY_WINDOW_LEN - 1) / MESSAGE_DISPLAY_WINDOW_LEN);
+}
+
+static parser_error_t _formatOutput(const char *label, uint16_t len, const uint8_t *message, bool allPrintable,
+                                    uint8_t windowIdx, char *outKey, uint16_t outKeyLen, char *outVal, uint16_t outValLen,
+                                    uint8_t pageIdx, uint8_t *pageCount) {
     if (outKey == NULL || outVal == NULL || label == NULL || pageCount == NULL || outKeyLen == 0 || outValLen == 0) {
         return parser_unexpected_error;
     }
@@ -33,18 +82,29 @@ static parser_error_t _formatOutput(const char *label, uint16_t len, const uint8
     if (len == 0) {
         snprintf(outKey, outKeyLen, "%s", label);
         snprintf(outVal, outValLen, "Empty");
+        return parser_ok;
+    }
+
+    const uint8_t windowCount = _windowCount(len);
+    if (windowIdx >= windowCount) {
+        return parser_display_idx_out_of_range;
+    }
+
+    const uint16_t windowOffset = (uint16_t)windowIdx * MESSAGE_DISPLAY_WINDOW_LEN;
+    const uint16_t windowLen =
+        (len - windowOffset) > MESSAGE_DISPLAY_WINDOW_LEN ? MESSAGE_DISPLAY_WINDOW_LEN : (len - windowOffset);
+
+    const char *hexSuffix = allPrintable ? "" : " (hex)";
+    if (windowCount > 1) {
+        snprintf(outKey, outKeyLen, "%s %d/%d%s", label, windowIdx + 1, windowCount, hexSuffix);
     } else {
-        bool allPrintable = true;
-        for (uint16_t i = 0; i < len; i++) {
-            allPrintable &= IS_PRINTABLE(message[i]);
-        }
-        if (allPrintable) {
-            snprintf(outKey, outKeyLen, "%s", label);
-            pageStringExt(outVal, outValLen, (const char *)message, len, pageIdx, pageCount);
-        } else {
-            snprintf(outKey, outKeyLen, "%s (hex)", label);
-            pageStringHex(outVal, outValLen, (const char *)message, len, pageIdx, pageCount);
-        }
+        snprintf(outKey, outKeyLen, "%s%s", label, hexSuffix);
+    }
+
+    if (allPrintable) {
+        pageStringExt(outVal, outValLen, (const char *)message + windowOffset, windowLen, pageIdx, pageCount);
+    } else {
+        CHECK_ERROR(pageHexString(outVal, outValLen, message + windowOffset, windowLen, false, 0, pageIdx, pageCount));
     }
     return parser_ok;
 }
@@ -138,6 +198,7 @@ static parser_error_t parser_message_read(parser_context_t *c, parser_message_tx
     if (c == NULL || v == NULL) {
         return parser_unexpected_error;
     }
+    MEMZERO(v, sizeof(*v));
 
     uint16_t prefix_len;
     uint16_t message_len;
@@ -150,6 +211,9 @@ static parser_error_t parser_message_read(parser_context_t *c, parser_message_tx
     if (message_len > 0) {
         CHECK_ERROR(readFixedArray(c, &v->message, message_len));
     }
+    // Classified once here, every page of the review would otherwise rescan the whole field
+    v->prefixPrintable = _allPrintable(v->prefix.ptr, v->prefix.len);
+    v->messagePrintable = _allPrintable(v->message.ptr, v->message.len);
 
     if (c->offset != c->bufferLen) {
         return parser_unexpected_unparsed_bytes;
@@ -158,15 +222,85 @@ static parser_error_t parser_message_read(parser_context_t *c, parser_message_tx
     return parser_ok;
 }
 
+void parser_message_digest_init(parser_message_digest_t *digest) {
+    MEMZERO(digest, sizeof(*digest));
+    digest->valid = zxblake3_hash_init() == parser_ok;
+    digest->hashSession = zxblake3_hash_session();
+}
+
+parser_error_t parser_message_digest_update(parser_message_digest_t *digest, const uint8_t *chunk, uint16_t chunkLen) {
+    if (digest == NULL || (chunk == NULL && chunkLen > 0)) {
+        return parser_unexpected_error;
+    }
+    // Another hash was started since init, parsing falls back to hashing the message in one go
+    if (!digest->valid || digest->hashSession != zxblake3_hash_session()) {
+        digest->valid = false;
+        return parser_ok;
+    }
+
+    const uint32_t chunkStart = digest->received;
+    digest->received += chunkLen;
+    for (uint32_t pos = chunkStart; pos < MESSAGE_HEADER_LEN && pos < digest->received; pos++) {
+        digest->header[pos] = chunk[pos - chunkStart];
+    }
+    if (digest->received < MESSAGE_HEADER_LEN) {
+        return parser_ok;
+    }
+
+    // Only the message field is hashed, its bounds follow from the header
+    const uint16_t prefixLen = (uint16_t)(digest->header[0] | (digest->header[1] << 8));
+    const uint16_t messageLen = (uint16_t)(digest->header[2] | (digest->header[3] << 8));
+    const uint32_t messageStart = MESSAGE_HEADER_LEN + prefixLen + MESSAGE_DOMAIN_LEN;
+    const uint32_t messageEnd = messageStart + messageLen;
+
+    const uint32_t from = chunkStart > messageStart ? chunkStart : messageStart;
+    const uint32_t to = digest->received < messageEnd ? digest->received : messageEnd;
+    if (from < to && zxblake3_hash_update_stream(chunk + (from - chunkStart), to - from) != parser_ok) {
+        digest->valid = false;
+    }
+    return parser_ok;
+}
+
+static parser_error_t parser_message_digest(parser_message_tx_t *v, uint8_t displayFlags, size_t dataLen,
+                                            const parser_message_digest_t *streamed) {
+    v->digestOnly = (displayFlags & DISPLAY_FLAG_MESSAGE_DIGEST) != 0 && v->message.len > MESSAGE_HEX_MAX_LEN &&
+                    !v->messagePrintable;
+    if (!v->digestOnly) {
+        return parser_ok;
+    }
+
+    // The streamed digest covers the message only if it saw every byte of this buffer
+    if (streamed != NULL && streamed->valid && streamed->received == dataLen &&
+        streamed->hashSession == zxblake3_hash_session()) {
+        return zxblake3_hash_finalize(v->digest, sizeof(v->digest));
+    }
+    return zxblake3_hash(v->message.ptr, v->message.len, v->digest, sizeof(v->digest));
+}
+
 parser_error_t parser_message_parse(parser_context_t *ctx, const uint8_t *data, size_t dataLen,
                                     parser_message_tx_t *tx_obj) {
+    return parser_message_parse_streamed(ctx, data, dataLen, tx_obj, 0, NULL);
+}
+
+parser_error_t parser_message_parse_streamed(parser_context_t *ctx, const uint8_t *data, size_t dataLen,
+                                             parser_message_tx_t *tx_obj, uint8_t displayFlags,
+                                             const parser_message_digest_t *streamed) {
     CHECK_ERROR(parser_message_init_context(ctx, data, dataLen));
     ctx->message_tx_obj = tx_obj;
-    return parser_message_read(ctx, tx_obj);
+    ctx->displayFlags = displayFlags;
+    CHECK_ERROR(parser_message_read(ctx, tx_obj));
+    return parser_message_digest(tx_obj, displayFlags, dataLen, streamed);
 }
 
-parser_error_t parser_message_getNumItems(uint8_t *num_items) {
-    *num_items = 4;
+parser_error_t parser_message_getNumItems(const parser_context_t *ctx, uint8_t *num_items) {
+    *num_items = 0;
+    if (ctx == NULL || ctx->message_tx_obj == NULL) {
+        return parser_tx_obj_empty;
+    }
+
+    // Sign, Domain and one item per prefix/message window. A digest-only message has a length and a digest item.
+    const parser_message_tx_t *msg = ctx->message_tx_obj;
+    *num_items = 2 + _windowCount(msg->prefix.len) + (msg->digestOnly ? 2 : _windowCount(msg->message.len));
     return parser_ok;
 }
 
@@ -175,30 +309,44 @@ parser_error_t parser_message_getItem(const parser_context_t *ctx, uint8_t displ
     UNUSED(pageIdx);
     *pageCount = 1;
     uint8_t numItems = 0;
-    CHECK_ERROR(parser_message_getNumItems(&numItems));
+    CHECK_ERROR(parser_message_getNumItems(ctx, &numItems));
     CHECK_APP_CANARY()
 
     CHECK_ERROR(parser_message_checkSanity(numItems, displayIdx));
 
     parser_message_cleanOutput(outKey, outKeyLen, outVal, outValLen);
 
-    switch (displayIdx) {
-        case 0:
-            snprintf(outKey, outKeyLen, "Sign");
-            snprintf(outVal, outValLen, "Message");
-            break;
-        case 1:
-            return _formatOutput("Prefix", ctx->message_tx_obj->prefix.len, ctx->message_tx_obj->prefix.ptr, outKey,
-                                 outKeyLen, outVal, outValLen, pageIdx, pageCount);
-        case 2:
-            snprintf(outKey, outKeyLen, "Domain");
-            return _printDomain(outVal, outValLen, ctx->message_tx_obj->domain);
-        case 3:
-            return _formatOutput("Msg", ctx->message_tx_obj->message.len, ctx->message_tx_obj->message.ptr, outKey,
-                                 outKeyLen, outVal, outValLen, pageIdx, pageCount);
-        default:
-            return parser_no_data;
+    const parser_message_tx_t *msg = ctx->message_tx_obj;
+    const uint8_t prefixItems = _windowCount(msg->prefix.len);
+    const uint8_t domainIdx = 1 + prefixItems;
+
+    if (displayIdx == 0) {
+        snprintf(outKey, outKeyLen, "Sign");
+        snprintf(outVal, outValLen, "Message");
+        return parser_ok;
     }
 
-    return parser_ok;
+    if (displayIdx < domainIdx) {
+        return _formatOutput("Prefix", msg->prefix.len, msg->prefix.ptr, msg->prefixPrintable, displayIdx - 1, outKey,
+                             outKeyLen, outVal, outValLen, pageIdx, pageCount);
+    }
+
+    if (displayIdx == domainIdx) {
+        snprintf(outKey, outKeyLen, "Domain");
+        return _printDomain(outVal, outValLen, msg->domain);
+    }
+
+    if (msg->digestOnly) {
+        if (displayIdx == domainIdx + 1) {
+            snprintf(outKey, outKeyLen, "Msg length");
+            snprintf(outVal, outValLen, "%d bytes", msg->message.len);
+            return parser_ok;
+        }
+        snprintf(outKey, outKeyLen, "Msg BLAKE3");
+        CHECK_ERROR(pageHexString(outVal, outValLen, msg->digest, sizeof(msg->digest), false, 0, pageIdx, pageCount));
+        return parser_ok;
+    }
+
+    return _formatOutput("Msg", msg->message.len, msg->message.ptr, msg->messagePrintable, displayIdx - domainIdx - 1,
+                         outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
 }
@@ -25,7 +25,18 @@ extern "C" {
 //// parses a raw tx buffer
 parser_error_t parser_message_parse(parser_context_t *ctx, const uint8_t *data, size_t dataLen, parser_message_tx_t *tx_obj);
 
-parser_error_t parser_message_getNumItems(uint8_t *num_items);
+// Streams the payload chunks through the hasher as they are received, so a long binary message does not need a
+// second pass over the buffer at parse time. Init is called when the first data chunk is expected.
+void parser_message_digest_init(parser_message_digest_t *digest);
+parser_error_t parser_message_digest_update(parser_message_digest_t *digest, const uint8_t *chunk, uint16_t chunkLen);
+
+// Same as parser_message_parse, with the DISPLAY_FLAG_* bits of the request. With DISPLAY_FLAG_MESSAGE_DIGEST, long
+// binary messages are reviewed by digest, using the streamed digest when it covers the whole buffer.
+parser_error_t parser_message_parse_streamed(parser_context_t *ctx, const uint8_t *data, size_t dataLen,
+                                             parser_message_tx_t *tx_obj, uint8_t displayFlags,
+                                             const parser_message_digest_t *streamed);
+
+parser_error_t parser_message_getNumItems(const parser_context_t *ctx, uint8_t *num_items);
 
 parser_error_t parser_message_getItem(const parser_context_t *ctx, uint8_t displayIdx, char *outKey, uint16_t outKeyLen,
                                       char *outVal, uint16_t outValLen, uint8_t pageIdx, uint8_t *pageCount);
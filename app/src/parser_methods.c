@@ -0,0 +1,89 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "parser_methods.h"
+
+#include <zxmacros.h>
+
+#include "parser.h"
+#include "parser_impl.h"
+
+#if !(PARSER_METHOD_SPEND || PARSER_METHOD_DRAIN_VAULT || PARSER_SPAWN_WALLET || PARSER_SPAWN_MULTISIG || \
+      PARSER_SPAWN_VESTING || PARSER_SPAWN_VAULT)
+#error "At least one tx method must be enabled"
+#endif
+
+// New templates and tx versions are added here. Lookup is a scan of this table at parse time, rendering then
+// indexes it with the tx's methodIdx.
+static const parser_method_t PARSER_METHODS[] = {
+#if PARSER_METHOD_SPEND
+    {TX_VERSION, METHOD_SPEND, UNKNOWN, _readSpendTx, getNumItemsSpend, printSpendTx},
+#endif
+#if PARSER_METHOD_DRAIN_VAULT
+    {TX_VERSION, METHOD_DRAIN_VAULT, UNKNOWN, _readDrainTx, getNumItemsDrain, printDrainTx},
+#endif
+#if PARSER_SPAWN_WALLET
+    {TX_VERSION, METHOD_SPAWN, WALLET, _readWalletSpawnTx, getNumItemsWalletSpawn, printWalletSpawn},
+#endif
+#if PARSER_SPAWN_MULTISIG
+    {TX_VERSION, METHOD_SPAWN, MULTISIG, _readMultisigSpawnTx, getNumItemsMultisigSpawn, printMultisigSpawn},
+#endif
+#if PARSER_SPAWN_VESTING
+    {TX_VERSION, METHOD_SPAWN, VESTING, _readMultisigSpawnTx, getNumItemsMultisigSpawn, printMultisigSpawn},
+#endif
+#if PARSER_SPAWN_VAULT
+    {TX_VERSION, METHOD_SPAWN, VAULT, _readVaultSpawnTx, getNumItemsVaultSpawn, printVaultSpawn},
+#endif
+};
+
+#define PARSER_METHODS_COUNT (sizeof(PARSER_METHODS) / sizeof(PARSER_METHODS[0]))
+
+bool parser_txVersionSupported(uint8_t txVersion) {
+    for (uint8_t i = 0; i < PARSER_METHODS_COUNT; i++) {
+        const parser_method_t *entry = (const parser_method_t *)PIC(&PARSER_METHODS[i]);
+        if (entry->txVersion == txVersion) {
+            return true;
+        }
+    }
+    return false;
+}
+
+parser_error_t parser_findMethod(const parser_context_t *ctx, parser_tx_t *tx) {
+    bool knownMethod = false;
+    for (uint8_t i = 0; i < PARSER_METHODS_COUNT; i++) {
+        const parser_method_t *entry = (const parser_method_t *)PIC(&PARSER_METHODS[i]);
+        if (entry->txVersion != tx->tx_version || entry->method != tx->methodSelector) {
+            continue;
+        }
+        knownMethod = true;
+
+        if (entry->templateType != UNKNOWN) {
+            CTX_CHECK_AVAIL(ctx, ADDRESS_LENGTH)
+            if (ctx->buffer[ctx->offset + ADDRESS_LENGTH - 1] != entry->templateType) {
+                continue;
+            }
+        }
+        tx->methodIdx = i;
+        return parser_ok;
+    }
+    return knownMethod ? parser_unexpected_value : parser_unexpected_method_selector;
+}
+
+const parser_method_t *parser_getMethod(uint8_t methodIdx) {
+    if (methodIdx >= PARSER_METHODS_COUNT) {
+        return NULL;
+    }
+    return (const parser_method_t *)PIC(&PARSER_METHODS[methodIdx]);
+}
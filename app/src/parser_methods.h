@@ -0,0 +1,80 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "parser_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Methods compiled into the parser. A build that does not need one sets it to 0, e.g. DEFINES += PARSER_SPAWN_VAULT=0,
+// and its decode and render code is left out of the image. Txs using it are rejected as unknown.
+#ifndef PARSER_METHOD_SPEND
+#define PARSER_METHOD_SPEND 1
+#endif
+#ifndef PARSER_METHOD_DRAIN_VAULT
+#define PARSER_METHOD_DRAIN_VAULT 1
+#endif
+#ifndef PARSER_SPAWN_WALLET
+#define PARSER_SPAWN_WALLET 1
+#endif
+#ifndef PARSER_SPAWN_MULTISIG
+#define PARSER_SPAWN_MULTISIG 1
+#endif
+#ifndef PARSER_SPAWN_VESTING
+#define PARSER_SPAWN_VESTING 1
+#endif
+#ifndef PARSER_SPAWN_VAULT
+#define PARSER_SPAWN_VAULT 1
+#endif
+
+// Reads everything after the method selector
+typedef parser_error_t (*parser_method_read_t)(parser_context_t *ctx, parser_tx_t *tx);
+typedef parser_error_t (*parser_method_num_items_t)(const parser_context_t *ctx, uint8_t *numItems);
+typedef parser_error_t (*parser_method_print_t)(const parser_context_t *ctx, uint8_t displayIdx, char *outKey,
+                                                uint16_t outKeyLen, char *outVal, uint16_t outValLen, uint8_t pageIdx,
+                                                uint8_t *pageCount);
+
+typedef struct {
+    uint8_t txVersion;
+    uint8_t method;
+    // Account type taken from the last byte of the template that follows the selector, UNKNOWN if the method
+    // does not start with a template
+    uint8_t templateType;
+    parser_method_read_t read;
+    parser_method_num_items_t numItems;
+    parser_method_print_t print;
+} parser_method_t;
+
+bool parser_txVersionSupported(uint8_t txVersion);
+
+/**
+ * Finds the registry entry of a tx whose version and method selector have been read, and stores its index in
+ * tx->methodIdx. ctx must be positioned right after the selector, the template is only peeked at.
+ * @return parser_unexpected_method_selector for unknown methods, parser_unexpected_value for unknown templates
+ */
+parser_error_t parser_findMethod(const parser_context_t *ctx, parser_tx_t *tx);
+
+// Entry found by parser_findMethod, NULL for an invalid index
+const parser_method_t *parser_getMethod(uint8_t methodIdx);
+
+#ifdef __cplusplus
+}
+#endif
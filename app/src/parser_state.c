@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "parser_state.h"
+
+#include <zxmacros.h>
+
+#include "parser.h"
+#include "parser_message.h"
+
+void parser_state_init(parser_state_t *state) { MEMZERO(state, sizeof(*state)); }
+
+parser_error_t parser_state_parseTx(parser_state_t *state, const uint8_t *data, size_t dataLen, uint8_t displayFlags,
+                                    network_e network, bool expert) {
+    if (state == NULL) {
+        return parser_unexpected_error;
+    }
+    parser_state_init(state);
+    CHECK_ERROR(parser_parse(&state->ctx, data, dataLen, &state->obj.tx));
+    state->ctx.displayFlags = displayFlags;
+    state->ctx.network = network;
+    state->ctx.expert = expert;
+    parser_attach_cache(&state->ctx, &state->cache);
+    return parser_ok;
+}
+
+parser_error_t parser_state_validateTx(parser_state_t *state, const uint8_t *data, size_t dataLen, uint8_t displayFlags,
+                                       network_e network, bool expert, uint16_t *errorOffset, uint8_t *numItems) {
+    if (state == NULL || errorOffset == NULL || numItems == NULL) {
+        return parser_unexpected_error;
+    }
+
+    parser_error_t err = parser_state_parseTx(state, data, dataLen, displayFlags, network, expert);
+    if (err == parser_ok) {
+        err = parser_validate(&state->ctx);
+    }
+    uint8_t items = 0;
+    if (err == parser_ok) {
+        err = parser_getNumItems(&state->ctx, &items);
+    }
+    *errorOffset = state->ctx.offset;
+    *numItems = err == parser_ok ? items : 0;
+
+    parser_state_init(state);
+    return err;
+}
+
+parser_error_t parser_state_parseMessage(parser_state_t *state, const uint8_t *data, size_t dataLen, uint8_t displayFlags,
+                                         const parser_message_digest_t *streamed) {
+    if (state == NULL) {
+        return parser_unexpected_error;
+    }
+    parser_state_init(state);
+    return parser_message_parse_streamed(&state->ctx, data, dataLen, &state->obj.message, displayFlags, streamed);
+}
+
+void parser_state_relocate(parser_state_t *state) {
+    // tx_obj and message_tx_obj share their storage, as do the parsed objects
+    if (state->ctx.tx_obj != NULL) {
+        state->ctx.tx_obj = &state->obj.tx;
+    }
+    if (state->ctx.cache != NULL) {
+        state->ctx.cache = &state->cache;
+    }
+}
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Everything one parsed blob needs: the context, the tx or message it was parsed into and the display cache. The
+// context points into this object, call parser_state_relocate after copying it. States share no parsed data, so any
+// number of them can be used side by side.
+typedef struct {
+    parser_context_t ctx;
+    union {
+        parser_tx_t tx;
+        parser_message_tx_t message;
+    } obj;
+    parser_display_cache_t cache;
+} parser_state_t;
+
+void parser_state_init(parser_state_t *state);
+
+// Parses a tx into state and attaches its display cache, render with parser_getNumItems/parser_getItem on state->ctx
+parser_error_t parser_state_parseTx(parser_state_t *state, const uint8_t *data, size_t dataLen, uint8_t displayFlags,
+                                    network_e network, bool expert);
+
+/**
+ * Parses and validates a tx as it would be before a review, without keeping it for one.
+ * @param errorOffset where the parser stopped: the field that failed to parse, or the end of the tx
+ * @param numItems items the review would show, 0 unless the tx is valid
+ */
+parser_error_t parser_state_validateTx(parser_state_t *state, const uint8_t *data, size_t dataLen, uint8_t displayFlags,
+                                       network_e network, bool expert, uint16_t *errorOffset, uint8_t *numItems);
+
+// Parses a message into state, render with parser_message_getNumItems/parser_message_getItem on state->ctx.
+// streamed is optional, see parser_message_parse_streamed.
+parser_error_t parser_state_parseMessage(parser_state_t *state, const uint8_t *data, size_t dataLen, uint8_t displayFlags,
+                                         const parser_message_digest_t *streamed);
+
+// Points the context of a copied state back at its own tx and cache
+void parser_state_relocate(parser_state_t *state);
+
+#ifdef __cplusplus
+}
+#endif
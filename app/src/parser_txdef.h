@@ -19,6 +19,7 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -42,31 +43,41 @@ typedef struct {
     const uint8_t *ptr;
 } CompactInt_t;
 
+// Fixed-size fields of a tx are stored as 16-bit offsets into the parsed buffer, their lengths are implied by the
+// field. Read them through the tx_* accessors below.
+typedef uint16_t buffer_offset_t;
+
 typedef struct {
-    Bytes_t destination;
     uint64_t amount;
+    buffer_offset_t destination;
 } spend_tx_t;
 
 typedef struct {
-    Bytes_t pubkey;
+    buffer_offset_t pubkey;
 } spawn_wallet_tx_t;
 
+#define KEYSET_DIGEST_LEN 32
+
 typedef struct {
     uint8_t approvers;
     uint8_t numberOfPubkeys;
-    Bytes_t pubkey[10];
+    // The pubkeys are contiguous in the buffer, numberOfPubkeys * PUB_KEY_LENGTH bytes from here
+    buffer_offset_t pubkeys;
+    // BLAKE3 of the ordered pubkeys, filled on the first render of the compact review's Key set item
+    uint8_t keysetDigest[KEYSET_DIGEST_LEN];
+    bool keysetDigestReady;
 } spawn_multisig_tx_t;
 
 typedef struct {
-    Bytes_t owner;
     uint64_t totalAmount;
     uint64_t initialUnlockAmount;
     uint32_t vestingStart;
     uint32_t vestingEnd;
+    buffer_offset_t owner;
 } spawn_vault_tx_t;
 
 typedef struct {
-    Bytes_t account_template;
+    buffer_offset_t account_template;
     union {
         spawn_wallet_tx_t wallet;
         spawn_multisig_tx_t multisig;
@@ -75,27 +86,93 @@ typedef struct {
 } spawn_tx_t;
 
 typedef struct {
-    Bytes_t vault;
-    Bytes_t destination;
     uint64_t amount;
+    buffer_offset_t vault;
+    buffer_offset_t destination;
 } drain_tx_t;
 
 typedef struct {
-    Bytes_t genesisId;
+    // Buffer the tx was parsed from, every buffer_offset_t is relative to it
+    const uint8_t *buffer;
+    uint64_t nonce;
+    uint64_t gas_price;
     account_type_e account_type;
+    buffer_offset_t genesisId;
+    buffer_offset_t principal;
     uint8_t tx_version;
-    Bytes_t principal;
     uint8_t methodSelector;
-    uint64_t nonce;
-    uint64_t gas_price;
+    // Entry of the method registry this tx was decoded with, see parser_methods.h
+    uint8_t methodIdx;
     union {
         spend_tx_t spend;
         spawn_tx_t spawn;
         drain_tx_t drain;
     };
-
 } parser_tx_t;
 
+__Z_INLINE const uint8_t *tx_field(const parser_tx_t *tx, buffer_offset_t offset) { return tx->buffer + offset; }
+
+// GENESIS_LENGTH bytes
+__Z_INLINE const uint8_t *tx_genesisId(const parser_tx_t *tx) { return tx_field(tx, tx->genesisId); }
+
+// ADDRESS_LENGTH bytes each
+__Z_INLINE const uint8_t *tx_principal(const parser_tx_t *tx) { return tx_field(tx, tx->principal); }
+__Z_INLINE const uint8_t *tx_spendDestination(const parser_tx_t *tx) { return tx_field(tx, tx->spend.destination); }
+__Z_INLINE const uint8_t *tx_drainVault(const parser_tx_t *tx) { return tx_field(tx, tx->drain.vault); }
+__Z_INLINE const uint8_t *tx_drainDestination(const parser_tx_t *tx) { return tx_field(tx, tx->drain.destination); }
+__Z_INLINE const uint8_t *tx_accountTemplate(const parser_tx_t *tx) { return tx_field(tx, tx->spawn.account_template); }
+__Z_INLINE const uint8_t *tx_vaultOwner(const parser_tx_t *tx) { return tx_field(tx, tx->spawn.vault.owner); }
+
+// PUB_KEY_LENGTH bytes each
+__Z_INLINE const uint8_t *tx_walletPubkey(const parser_tx_t *tx) { return tx_field(tx, tx->spawn.wallet.pubkey); }
+__Z_INLINE const uint8_t *tx_multisigPubkey(const parser_tx_t *tx, uint8_t idx) {
+    return tx_field(tx, (buffer_offset_t)(tx->spawn.multisig.pubkeys + (uint16_t)idx * PUB_KEY_LENGTH));
+}
+
+// Longest single item is a 32-byte pubkey in hex (64 chars)
+#define RENDER_CACHE_KEY_LEN 24
+#define RENDER_CACHE_VALUE_LEN 72
+
+// Holds one item, rendered with the display flags and network it records
+typedef struct {
+    bool valid;
+    uint8_t displayIdx;
+    uint8_t displayFlags;
+    network_e network;
+    uint8_t pageCount;
+    uint16_t pageLen;
+    uint16_t valueLen;
+    char key[RENDER_CACHE_KEY_LEN];
+    char value[RENDER_CACHE_VALUE_LEN];
+} parser_render_cache_t;
+
+// Longest encoding is a testnet address: "stest" + separator + 39 data + 6 checksum chars
+#define ADDRESS_MEMO_ENCODED_LEN 52
+#if defined(TARGET_NANOS)
+#define ADDRESS_MEMO_ENTRIES 2
+#else
+#define ADDRESS_MEMO_ENTRIES 4
+#endif
+
+// Keyed by the raw address, or by the pubkey for wallet addresses derived from it. The key lengths differ, so the two
+// never match each other. keyLen 0 marks an empty entry.
+typedef struct {
+    uint8_t keyLen;
+    uint8_t key[PUB_KEY_LENGTH];
+    char encoded[ADDRESS_MEMO_ENCODED_LEN];
+} address_memo_entry_t;
+
+// Most recently used entry first, all encoded for network
+typedef struct {
+    network_e network;
+    address_memo_entry_t entries[ADDRESS_MEMO_ENTRIES];
+} parser_address_memo_t;
+
+typedef struct {
+    parser_render_cache_t render;
+    parser_address_memo_t addresses;
+} parser_display_cache_t;
+
 typedef enum {
     ATX = 0,
     PROPOSAL = 1,
@@ -106,12 +183,32 @@ typedef enum {
     BEACON_FOLLOWUP_MSG = 11
 } domain_e;
 
+// BLAKE3-256 of the message field
+#define MESSAGE_DIGEST_LEN 32
+
 typedef struct {
     uint8_t domain;
     Bytes_t prefix;
     Bytes_t message;
+    // Printable fields are shown as text, the others as hex
+    bool prefixPrintable;
+    bool messagePrintable;
+    // Long binary messages are reviewed by their length and digest instead of hex pages
+    bool digestOnly;
+    uint8_t digest[MESSAGE_DIGEST_LEN];
 } parser_message_tx_t;
 
+// prefix len (u16) and message len (u16)
+#define MESSAGE_HEADER_LEN 4
+
+// Digest of the message field, fed with the payload chunks as they arrive
+typedef struct {
+    uint32_t received;
+    uint32_t hashSession;
+    uint8_t header[MESSAGE_HEADER_LEN];
+    bool valid;
+} parser_message_digest_t;
+
 #ifdef __cplusplus
 }
 #endif
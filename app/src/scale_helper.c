@@ -41,6 +41,15 @@ parser_error_t readFixedArray(parser_context_t *ctx, Bytes_t *val, uint16_t size
     return parser_ok;
 }
 
+parser_error_t readFixedOffset(parser_context_t *ctx, buffer_offset_t *val, uint16_t size) {
+    CHECK_INPUT();
+
+    *val = ctx->offset;
+    CTX_CHECK_AND_ADVANCE(ctx, size);
+
+    return parser_ok;
+}
+
 parser_error_t readCompactU64(parser_context_t *ctx, uint64_t *val) {
     CHECK_INPUT();
 
@@ -25,6 +25,8 @@ extern "C" {
 
 parser_error_t readBytes(parser_context_t *ctx, Bytes_t *val);
 parser_error_t readFixedArray(parser_context_t *ctx, Bytes_t *val, uint16_t size);
+// Records where a field of the given size starts and skips it
+parser_error_t readFixedOffset(parser_context_t *ctx, buffer_offset_t *val, uint16_t size);
 
 parser_error_t readCompactU64(parser_context_t *ctx, uint64_t *val);
 parser_error_t readCompactU32(parser_context_t *ctx, uint32_t *val);
@@ -20,10 +20,22 @@
 #include "parser_common.h"
 #include "zxmacros.h"
 
-static blake3_hasher zxblake3;
-static uint16_t accumInLen = 0;
+// The device runs a single thread; host tools may parse on several threads at once
+#if defined(TARGET_NANOS) || defined(TARGET_NANOX) || defined(TARGET_NANOS2) || defined(TARGET_STAX) || defined(TARGET_FLEX)
+#define HASHER_STATE static
+#else
+#define HASHER_STATE static _Thread_local
+#endif
 
-#define MAX_INPUT_LEN 4095  // (2^12 - 1)
+HASHER_STATE blake3_hasher zxblake3;
+HASHER_STATE uint32_t accumInLen = 0;
+HASHER_STATE uint32_t hashSession = 0;
+
+// The hasher chaining-value stack is sized by BLAKE3_MAX_DEPTH, which bounds the total input to 2^MAX_DEPTH chunks
+#define MAX_INPUT_LEN ((BLAKE3_CHUNK_LEN << BLAKE3_MAX_DEPTH) - 1)
+
+// Flash-resident data is fed to the hasher in windows of this size
+#define STREAM_WINDOW_LEN BLAKE3_CHUNK_LEN
 
 /**
  * @brief Computes the BLAKE3 hash of the input data.
@@ -34,7 +46,7 @@ static uint16_t accumInLen = 0;
  * @param outLen Length of the output buffer.
  * @return parser_error_t Returns parser_ok on success, or an error code on failure.
  */
-parser_error_t zxblake3_hash(const uint8_t *in, const uint16_t inLen, uint8_t *out, uint16_t outLen) {
+parser_error_t zxblake3_hash(const uint8_t *in, const uint32_t inLen, uint8_t *out, uint16_t outLen) {
     if (in == NULL || inLen == 0 || out == NULL || outLen < BLAKE3_OUT_LEN) {
         return parser_unexpected_error;
     }
@@ -43,10 +55,9 @@ parser_error_t zxblake3_hash(const uint8_t *in, const uint16_t inLen, uint8_t *o
         return parser_unexpected_value;
     }
 
-    MEMZERO(&zxblake3, sizeof(zxblake3));
-    blake3_hasher_init(&zxblake3);
-    blake3_hasher_update(&zxblake3, in, inLen);
-    blake3_hasher_finalize(&zxblake3, out, outLen);
+    CHECK_ERROR(zxblake3_hash_init());
+    CHECK_ERROR(zxblake3_hash_update_stream(in, inLen));
+    CHECK_ERROR(zxblake3_hash_finalize(out, outLen));
 
     return parser_ok;
 }
@@ -60,10 +71,20 @@ parser_error_t zxblake3_hash_init() {
     MEMZERO(&zxblake3, sizeof(zxblake3));
     blake3_hasher_init(&zxblake3);
     accumInLen = 0;
+    hashSession++;
 
     return parser_ok;
 }
 
+/**
+ * @brief Identifies the hash started by the last zxblake3_hash_init.
+ *
+ * A hash fed across several calls compares it before each update, to detect that another user restarted the hasher.
+ *
+ * @return uint32_t Value that changes with every zxblake3_hash_init.
+ */
+uint32_t zxblake3_hash_session() { return hashSession; }
+
 /**
  * @brief Updates the BLAKE3 hasher with additional input data.
  *
@@ -86,6 +107,35 @@ parser_error_t zxblake3_hash_update(const uint8_t *in, const uint16_t inLen) {
     return parser_ok;
 }
 
+/**
+ * @brief Updates the BLAKE3 hasher with a large input, one window at a time.
+ *
+ * Used for data living in the flash-backed tx buffer, which may exceed what a single update accepts.
+ *
+ * @param in Pointer to the input data.
+ * @param inLen Length of the input data.
+ * @return parser_error_t Returns parser_ok on success, or an error code on failure.
+ */
+parser_error_t zxblake3_hash_update_stream(const uint8_t *in, const uint32_t inLen) {
+    if (in == NULL || inLen == 0) {
+        return parser_unexpected_error;
+    }
+
+    if (inLen > MAX_INPUT_LEN - accumInLen) {
+        return parser_unexpected_value;
+    }
+
+    uint32_t offset = 0;
+    while (offset < inLen) {
+        const uint32_t remaining = inLen - offset;
+        const uint16_t windowLen = (uint16_t)(remaining > STREAM_WINDOW_LEN ? STREAM_WINDOW_LEN : remaining);
+        CHECK_ERROR(zxblake3_hash_update(in + offset, windowLen));
+        offset += windowLen;
+    }
+
+    return parser_ok;
+}
+
 /**
  * @brief Finalizes the BLAKE3 hash computation and produces the output hash.
  *
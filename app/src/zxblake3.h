@@ -23,10 +23,12 @@
 extern "C" {
 #endif
 
-parser_error_t zxblake3_hash(const uint8_t *in, uint16_t inLen, uint8_t *out, uint16_t outLen);
+parser_error_t zxblake3_hash(const uint8_t *in, uint32_t inLen, uint8_t *out, uint16_t outLen);
 
 parser_error_t zxblake3_hash_init();
+uint32_t zxblake3_hash_session();
 parser_error_t zxblake3_hash_update(const uint8_t *in, uint16_t inLen);
+parser_error_t zxblake3_hash_update_stream(const uint8_t *in, uint32_t inLen);
 parser_error_t zxblake3_hash_finalize(uint8_t *out, uint16_t outLen);
 
 #ifdef __cplusplus
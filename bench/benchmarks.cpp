@@ -0,0 +1,451 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <hexutils.h>
+#include <json/json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bech32.h"
+#include "coin.h"
+#include "crypto_helper.h"
+#include "format_helper.h"
+#include "parser.h"
+#include "spacemesh/corpus.hpp"
+#include "spacemesh/export.hpp"
+
+// Timing benchmarks of the parse, render and address derivation paths.
+//
+// Every benchmark median is divided by the median of a fixed calibration loop, so the scores in the baseline are
+// roughly independent of the machine running them. Both are measured in ROUNDS interleaved rounds and the lowest of
+// each is kept: load from other processes only ever makes a round slower, so the quietest round is the one closest to
+// the code's own cost. A score above baseline * (1 + tolerance) is measured again with more rounds once the whole pass is
+// done, and only fails if it stays above.
+//
+//   benchmarks                    compare against the baseline
+//   benchmarks --update-baseline  rewrite the scores, keeping the per-benchmark tolerances
+//   benchmarks --filter <text>    only run benchmarks whose name contains <text>
+//   benchmarks --corpus <file>    parse and render every tx of a corpus built by json2corpus, report throughput
+
+using namespace std;
+
+namespace {
+constexpr double DEFAULT_TOLERANCE = 0.25;
+constexpr size_t SAMPLES = 21;
+constexpr size_t ROUNDS = 5;
+constexpr size_t RETRIES = 3;
+constexpr chrono::nanoseconds MIN_SAMPLE_TIME = chrono::milliseconds(2);
+
+struct Benchmark {
+    string name;
+    function<void()> run;
+};
+
+struct Result {
+    string name;
+    double medianNs;
+    double score;
+    double calibrationNs;
+};
+
+// Keeps the optimizer from dropping work whose result is otherwise unused
+template <typename T>
+void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+double medianNs(const function<void()> &run) {
+    // Pick an iteration count that makes each sample long enough for the clock
+    uint64_t iterations = 1;
+    while (true) {
+        const auto start = chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            run();
+        }
+        if (chrono::steady_clock::now() - start >= MIN_SAMPLE_TIME) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    vector<double> samples;
+    samples.reserve(SAMPLES);
+    for (size_t s = 0; s < SAMPLES; s++) {
+        const auto start = chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            run();
+        }
+        const chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+        samples.push_back(elapsed.count() / static_cast<double>(iterations));
+    }
+
+    nth_element(samples.begin(), samples.begin() + SAMPLES / 2, samples.end());
+    return samples[SAMPLES / 2];
+}
+
+// Integer and table work that does not touch app code
+void calibration() {
+    static uint8_t table[256];
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < 256; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        table[i] = static_cast<uint8_t>(table[(x >> 8) & 0xFF] + x);
+    }
+    doNotOptimize(table);
+}
+
+// Lowest benchmark median over the lowest calibration median, both taken over the given number of rounds. Taking the
+// minimum of each separately keeps a round whose calibration alone was slowed down from lowering the score.
+Result measure(const Benchmark &b, size_t rounds) {
+    double ns = 0.0;
+    double calibrationNs = 0.0;
+    for (size_t r = 0; r < rounds; r++) {
+        const double roundCalibrationNs = medianNs(calibration);
+        const double roundNs = medianNs(b.run);
+        calibrationNs = r == 0 ? roundCalibrationNs : min(calibrationNs, roundCalibrationNs);
+        ns = r == 0 ? roundNs : min(ns, roundNs);
+    }
+    return {b.name, ns, ns / calibrationNs, calibrationNs};
+}
+
+vector<uint8_t> loadBlob(const Json::Value &testcases, const string &name) {
+    for (const auto &tc : testcases) {
+        if (tc["name"].asString() == name) {
+            vector<uint8_t> blob(tc["blob"].asString().size() / 2);
+            blob.resize(parseHexString(blob.data(), blob.size(), tc["blob"].asCString()));
+            return blob;
+        }
+    }
+    fprintf(stderr, "testcase %s not found\n", name.c_str());
+    exit(EXIT_FAILURE);
+}
+
+struct ParsedTx {
+    vector<uint8_t> blob;
+    parser_tx_t tx;
+    parser_context_t ctx;
+    parser_display_cache_t cache;
+};
+
+// Renders every item and page of the expert review the way the device UI does
+void renderAll(ParsedTx *p) {
+    char key[40];
+    char value[40];
+
+    p->ctx.expert = true;
+    parser_attach_cache(&p->ctx, &p->cache);
+    uint8_t numItems = 0;
+    parser_getNumItems(&p->ctx, &numItems);
+    for (uint8_t idx = 0; idx < numItems; idx++) {
+        uint8_t pageCount = 1;
+        for (uint8_t page = 0; page < pageCount; page++) {
+            parser_getItem(&p->ctx, idx, key, sizeof(key), value, sizeof(value), page, &pageCount);
+            doNotOptimize(value);
+        }
+    }
+}
+
+vector<Benchmark> buildBenchmarks(const Json::Value &testcases, vector<unique_ptr<ParsedTx>> &storage) {
+    vector<Benchmark> benchmarks;
+
+    for (const char *name : {"sm_Wallet_spend", "sm_Multisig_9_10_spawn", "sm_Vault_5_9_spawn", "sm_Vault_5_9_drain"}) {
+        storage.emplace_back(new ParsedTx());
+        ParsedTx *p = storage.back().get();
+        p->blob = loadBlob(testcases, name);
+        if (parser_parse(&p->ctx, p->blob.data(), p->blob.size(), &p->tx) != parser_ok) {
+            fprintf(stderr, "testcase %s does not parse\n", name);
+            exit(EXIT_FAILURE);
+        }
+
+        benchmarks.push_back({string("parser_parse/") + name, [p] {
+                                  parser_parse(&p->ctx, p->blob.data(), p->blob.size(), &p->tx);
+                                  doNotOptimize(p->tx);
+                              }});
+        benchmarks.push_back({string("render/") + name, [p] {
+                                  parser_parse(&p->ctx, p->blob.data(), p->blob.size(), &p->tx);
+                                  renderAll(p);
+                              }});
+    }
+
+    // Field export of the largest vector, the indexer path that skips display formatting
+    const ParsedTx *multisig = storage[1].get();
+    benchmarks.push_back({"exportTx/json/sm_Multisig_9_10_spawn", [multisig] {
+                              uint8_t out[1024];
+                              doNotOptimize(spacemesh::exportTx(multisig->tx, spacemesh::ExportFormat::Json, out,
+                                                                sizeof(out)));
+                          }});
+    benchmarks.push_back({"exportTx/cbor/sm_Multisig_9_10_spawn", [multisig] {
+                              uint8_t out[1024];
+                              doNotOptimize(spacemesh::exportTx(multisig->tx, spacemesh::ExportFormat::Cbor, out,
+                                                                sizeof(out)));
+                          }});
+
+    benchmarks.push_back({"formatFixedPoint/amount", [] {
+                              char out[FIXED_POINT_BUFFER_LEN];
+                              formatFixedPoint(out, sizeof(out), 123456789012345678ULL, COIN_AMOUNT_DECIMAL_PLACES, "",
+                                               COIN_TICKER);
+                              doNotOptimize(out);
+                          }});
+
+    static const uint8_t pubkey[32] = {0x97, 0xf3, 0xbd, 0x87, 0x13, 0x15, 0x28, 0x1e, 0x8b, 0x83, 0xed,
+                                       0xc7, 0xa9, 0xfd, 0x05, 0x41, 0x06, 0x61, 0x54, 0x44, 0x90, 0x70,
+                                       0xcc, 0xdb, 0x3c, 0xdd, 0x42, 0xcf, 0x69, 0xcc, 0xde, 0x88};
+
+    benchmarks.push_back({"pageHexString/pubkey", [] {
+                              char out[40];
+                              uint8_t pageCount = 0;
+                              for (uint8_t page = 0; page < 2; page++) {
+                                  pageHexString(out, sizeof(out), pubkey, sizeof(pubkey), false, 0, page, &pageCount);
+                                  doNotOptimize(out);
+                              }
+                          }});
+
+    static generic_account_t account;
+    static vault_account_t vault;
+    static pubkey_item_t internalPubkey;
+    account.approvers = 5;
+    account.participants = MAX_MULTISIG_PUB_KEY;
+    for (uint8_t i = 0; i < MAX_MULTISIG_PUB_KEY - 1; i++) {
+        account.keys[i].index = i + 1;
+        MEMCPY(account.keys[i].pubkey, pubkey, sizeof(pubkey));
+        account.keys[i].pubkey[0] = i;
+    }
+    internalPubkey.index = 0;
+    MEMCPY(internalPubkey.pubkey, pubkey, sizeof(pubkey));
+    vault.totalAmount = 1000000000000000ULL;
+    vault.initialUnlockAmount = 100000000000000ULL;
+    vault.vestingStart = 105120;
+    vault.vestingEnd = 420480;
+    vault.owner = &account;
+
+    benchmarks.push_back({"crypto_encodeWalletPubkey", [] {
+                              uint8_t address[MAX_ADDRESS_LENGTH];
+                              crypto_encodeWalletPubkey(address, sizeof(address), pubkey);
+                              doNotOptimize(address);
+                          }});
+    benchmarks.push_back({"crypto_encodeAccountPubkey/multisig_5_10", [] {
+                              uint8_t address[MAX_ADDRESS_LENGTH];
+                              crypto_encodeAccountPubkey(address, sizeof(address), &internalPubkey, &account, MULTISIG);
+                              doNotOptimize(address);
+                          }});
+    benchmarks.push_back({"crypto_encodeVaultPubkey/vesting_5_10", [] {
+                              uint8_t address[MAX_ADDRESS_LENGTH];
+                              crypto_encodeVaultPubkey(address, sizeof(address), &internalPubkey, &vault);
+                              doNotOptimize(address);
+                          }});
+    benchmarks.push_back({"bech32EncodeFromBytes/address", [] {
+                              char out[MAX_ADDRESS_LENGTH];
+                              bech32EncodeFromBytes(out, sizeof(out), "sm", pubkey, ADDRESS_LENGTH, 1,
+                                                    BECH32_ENCODING_BECH32);
+                              doNotOptimize(out);
+                          }});
+
+    return benchmarks;
+}
+
+// Throughput over a whole corpus, not compared against the baseline
+int runCorpus(const string &path) {
+    try {
+        const spacemesh::CorpusFile file(path);
+        size_t txCount = 0;
+        size_t failures = 0;
+        ParsedTx p;
+        const double ns = medianNs([&] {
+            txCount = 0;
+            failures = 0;
+            for (const auto entry : file.view()) {
+                if (entry.type() != spacemesh::BlobType::Tx) {
+                    continue;
+                }
+                txCount++;
+                if (parser_parse(&p.ctx, entry.blob().data(), entry.blob().size(), &p.tx) != parser_ok) {
+                    failures++;
+                    continue;
+                }
+                p.ctx.displayFlags = entry.compact() ? DISPLAY_FLAG_COMPACT : 0;
+                p.ctx.network = entry.mainnet() ? NETWORK_MAINNET : NETWORK_TESTNET;
+                renderAll(&p);
+            }
+        });
+        printf("%zu txs (%zu failed to parse), %.1f ns/tx, %.0f tx/s\n", txCount, failures,
+               ns / static_cast<double>(max<size_t>(txCount, 1)), txCount * 1e9 / ns);
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const spacemesh::Error &e) {
+        fprintf(stderr, "could not read corpus %s: %s\n", path.c_str(), e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+bool readJson(const string &path, Json::Value *out) {
+    ifstream in(path);
+    if (!in.good()) {
+        return false;
+    }
+    Json::CharReaderBuilder builder;
+    JSONCPP_STRING errs;
+    return Json::parseFromStream(builder, in, out, &errs);
+}
+
+bool writeBaseline(const string &path, const Json::Value &previous, const vector<Result> &results) {
+    Json::Value root;
+    double calibrationNs = results.empty() ? 0.0 : results.front().calibrationNs;
+    for (const auto &r : results) {
+        calibrationNs = min(calibrationNs, r.calibrationNs);
+        Json::Value entry;
+        entry["score"] = r.score;
+        entry["tolerance"] = previous["benchmarks"][r.name].get("tolerance", DEFAULT_TOLERANCE);
+        root["benchmarks"][r.name] = entry;
+    }
+    root["calibration_ns"] = calibrationNs;
+
+    ofstream out(path);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "    ";
+    builder["precision"] = 4;
+    builder["precisionType"] = "decimal";
+    out << Json::writeString(builder, root) << endl;
+    return out.good();
+}
+
+bool regressed(const Json::Value &entry, const Result &r) {
+    const double expected = entry["score"].asDouble();
+    return r.score > expected * (1.0 + entry.get("tolerance", DEFAULT_TOLERANCE).asDouble());
+}
+
+// Prints one line per benchmark and returns the number of regressions
+int compare(const Json::Value &baseline, const vector<Result> &results) {
+    int failures = 0;
+    printf("\n%-44s %10s %10s %9s %9s\n", "benchmark", "baseline", "current", "change", "allowed");
+    for (const auto &r : results) {
+        const Json::Value &entry = baseline["benchmarks"][r.name];
+        if (!entry.isObject()) {
+            printf("%-44s %10s %10.3f %9s %9s  MISSING\n", r.name.c_str(), "-", r.score, "-", "-");
+            failures++;
+            continue;
+        }
+
+        const double expected = entry["score"].asDouble();
+        const double tolerance = entry.get("tolerance", DEFAULT_TOLERANCE).asDouble();
+        const double change = (r.score - expected) / expected;
+        const bool failed = regressed(entry, r);
+        printf("%-44s %10.3f %10.3f %+8.1f%% %8.0f%%%s\n", r.name.c_str(), expected, r.score, change * 100.0,
+               tolerance * 100.0, failed ? "  REGRESSED" : "");
+        failures += failed ? 1 : 0;
+    }
+    return failures;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    string baselinePath = BENCH_BASELINE;
+    string filter;
+    string corpusPath;
+    bool update = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update-baseline") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpusPath = argv[++i];
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--update-baseline] [--baseline <path>] [--filter <text>] [--corpus <file>]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!corpusPath.empty()) {
+        return runCorpus(corpusPath);
+    }
+
+    Json::Value testcases;
+    if (!readJson(string(TESTVECTORS_DIR) + "testcases.json", &testcases)) {
+        fprintf(stderr, "could not read testcases.json\n");
+        return EXIT_FAILURE;
+    }
+
+    vector<unique_ptr<ParsedTx>> storage;
+    const vector<Benchmark> benchmarks = buildBenchmarks(testcases, storage);
+
+    Json::Value baseline;
+    const bool haveBaseline = readJson(baselinePath, &baseline);
+
+    vector<const Benchmark *> selected;
+    vector<Result> results;
+    for (const auto &b : benchmarks) {
+        if (!filter.empty() && b.name.find(filter) == string::npos) {
+            continue;
+        }
+        selected.push_back(&b);
+        results.push_back(measure(b, ROUNDS));
+        printf("%-44s %10.1f ns\n", b.name.c_str(), results.back().medianNs);
+    }
+
+    // A busy stretch can slow down every round of a benchmark, so a regression has to show up again in longer runs
+    // measured after the whole pass, when the stretch is likely over
+    for (size_t retry = 0; !update && retry < RETRIES; retry++) {
+        for (size_t i = 0; i < results.size(); i++) {
+            const Json::Value &entry = baseline["benchmarks"][results[i].name];
+            if (!entry.isObject() || !regressed(entry, results[i])) {
+                continue;
+            }
+            const Result again = measure(*selected[i], ROUNDS * 2);
+            printf("%-44s %10.1f ns (retry %zu)\n", again.name.c_str(), again.medianNs, retry + 1);
+            if (again.score < results[i].score) {
+                results[i] = again;
+            }
+        }
+    }
+
+    if (update) {
+        if (!filter.empty()) {
+            fprintf(stderr, "--update-baseline cannot be combined with --filter\n");
+            return EXIT_FAILURE;
+        }
+        if (!writeBaseline(baselinePath, baseline, results)) {
+            fprintf(stderr, "could not write %s\n", baselinePath.c_str());
+            return EXIT_FAILURE;
+        }
+        printf("\nBaseline written to %s\n", baselinePath.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    if (!haveBaseline) {
+        fprintf(stderr, "could not read baseline %s, run with --update-baseline\n", baselinePath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    const int failures = compare(baseline, results);
+    if (failures > 0) {
+        printf("\n%d benchmark(s) regressed or missing from the baseline\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("\nAll benchmarks within tolerance\n");
+    return EXIT_SUCCESS;
+}
@@ -35,7 +35,13 @@ extern "C" {
 #define BLAKE3_OUT_LEN 32
 #define BLAKE3_BLOCK_LEN 64
 #define BLAKE3_CHUNK_LEN 1024
-#define BLAKE3_MAX_DEPTH 2
+// Sized so a single hash covers the whole tx buffer (2^depth chunks): 16 KiB, or 8 KiB on Nano S.
+// zxblake3 derives its input cap from this value and rejects anything longer.
+#if defined(TARGET_NANOS)
+#define BLAKE3_MAX_DEPTH 3
+#else
+#define BLAKE3_MAX_DEPTH 4
+#endif
 
 // This struct is a private implementation detail. It has to be here because
 // it's part of blake3_hasher below.
@@ -0,0 +1,71 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "bech32.h"
+#include "crypto_helper.h"
+#include "zxformat.h"
+
+#ifdef NDEBUG
+#error "This fuzz target won't work correctly with NDEBUG defined, which will cause asserts to be eliminated"
+#endif
+
+// Address requests (INS_GET_ADDR_MULTISIG/VESTING/VAULT) through parseAddressRequest and the address derivation.
+//
+// The first input byte selects the account type, the rest stands in for the tx buffer. It is copied into an
+// allocation of the exact size so any read past the request is caught by ASan.
+
+using std::size_t;
+
+namespace {
+const uint8_t INTERNAL_PUBKEY[PUB_KEY_LENGTH] = {0x3b, 0x15, 0x97, 0xe3, 0x4d, 0x63, 0x01, 0x73, 0x55, 0x39, 0x7c,
+                                                 0xaf, 0xe5, 0xef, 0x52, 0x54, 0xc0, 0x4f, 0x1f, 0x00, 0xdf, 0x16,
+                                                 0x4b, 0xb0, 0x65, 0x51, 0xc1, 0x43, 0x3d, 0x46, 0x04, 0x59};
+
+const account_type_e ACCOUNT_TYPES[] = {MULTISIG, VESTING, VAULT};
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size < 1 || size - 1 > UINT16_MAX) {
+        return 0;
+    }
+
+    const account_type_e accountType = ACCOUNT_TYPES[data[0] % 3];
+    const std::vector<uint8_t> buffer(data + 1, data + size);
+
+    address_request_t request;
+    if (parseAddressRequest(buffer.data(), static_cast<uint16_t>(buffer.size()), accountType, &request) != zxerr_ok) {
+        return 0;
+    }
+    assert(request.account_type == accountType);
+    assert(request.internalIndex <= request.optional_numberOfPubkeys);
+
+    pubkey_item_t internalPubkey;
+    internalPubkey.index = request.internalIndex;
+    memcpy(internalPubkey.pubkey, INTERNAL_PUBKEY, sizeof(internalPubkey.pubkey));
+
+    uint8_t address[MAX_ADDRESS_LENGTH] = {0};
+    zxerr_t err = zxerr_unknown;
+    if (accountType == VAULT) {
+        err = crypto_encodeVaultPubkey(address, sizeof(address), &internalPubkey, &request.vault_account);
+    } else {
+        err = crypto_encodeAccountPubkey(address, sizeof(address), &internalPubkey, request.account, accountType);
+    }
+
+    // Requests are fully validated when decoded, so every accepted one derives an address
+    if (err != zxerr_ok) {
+        (void)fprintf(stderr, "derivation of an accepted request failed: %d\n", err);
+        assert(false);
+    }
+
+    char encoded[MAX_ADDRESS_LENGTH + 8] = {0};
+    err = bech32EncodeFromBytes(encoded, sizeof(encoded), "stest", address, ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32);
+    if (err != zxerr_ok) {
+        (void)fprintf(stderr, "bech32 encoding failed: %d\n", err);
+        assert(false);
+    }
+
+    return 0;
+}
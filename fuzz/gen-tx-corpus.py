@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Seed corpus for the structure-aware tx fuzzer.
+
+Writes every tx blob from tests/testcases.json plus synthetic transactions
+built with the same grammar as fuzz/parser_parse_structured.cpp: all spawn
+account types, spends and drains, with compact ints around the mode
+boundaries.
+"""
+
+import hashlib
+import json
+import os
+import random
+
+TESTCASES = os.path.join('tests', 'testcases.json')
+CORPUS_DIR = os.path.join('fuzz', 'corpora', 'parser_parse_structured')
+SYNTHETIC_COUNT = 512
+
+GENESIS_LENGTH = 20
+ADDRESS_LENGTH = 24
+PUB_KEY_LENGTH = 32
+MAX_MULTISIG_PUB_KEY = 10
+
+METHOD_SPAWN = 0
+METHOD_SPEND = 16
+METHOD_DRAIN_VAULT = 17
+
+WALLET, MULTISIG, VESTING, VAULT = 1, 2, 3, 4
+
+BOUNDARY_VALUES = [0, 1, 63, 64, 16383, 16384, (1 << 30) - 1, 1 << 30, (1 << 32) - 1, 1 << 32,
+                   1000000000, (1 << 62) - 1]
+
+
+def compact(value, mode=None):
+    minimal = 0 if value < (1 << 6) else 1 if value < (1 << 14) else 2 if value < (1 << 30) else 3
+    mode = minimal if mode is None or mode < minimal else mode
+    if mode == 0:
+        return bytes([value << 2])
+    if mode == 1:
+        return ((value << 2) | 1).to_bytes(2, 'little')
+    if mode == 2:
+        return ((value << 2) | 2).to_bytes(4, 'little')
+    length = max(4, (value.bit_length() + 7) // 8)
+    return bytes([((length - 4) << 2) | 3]) + value.to_bytes(length, 'little')
+
+
+def rand_value(rng):
+    return rng.choice(BOUNDARY_VALUES) if rng.random() < 0.5 else rng.randrange(1 << rng.randint(1, 62))
+
+
+def header(rng, selector):
+    return rng.randbytes(GENESIS_LENGTH) + compact(0) + rng.randbytes(ADDRESS_LENGTH) + compact(selector)
+
+
+def spawn(rng, account_type):
+    template = rng.randbytes(ADDRESS_LENGTH - 1) + bytes([account_type])
+    tx = header(rng, METHOD_SPAWN) + template + compact(rand_value(rng)) + compact(rand_value(rng))
+    if account_type == WALLET:
+        return tx + rng.randbytes(PUB_KEY_LENGTH)
+    if account_type in (MULTISIG, VESTING):
+        keys = rng.randint(1, MAX_MULTISIG_PUB_KEY)
+        tx += compact(rng.randint(1, keys)) + compact(keys)
+        return tx + b''.join(rng.randbytes(PUB_KEY_LENGTH) for _ in range(keys))
+    total = rand_value(rng)
+    start = rng.randrange(1 << 20)
+    tx += rng.randbytes(ADDRESS_LENGTH) + compact(total) + compact(rng.randint(0, total))
+    return tx + compact(start) + compact(start + rng.randrange(1 << 20))
+
+
+def spend(rng):
+    return (header(rng, METHOD_SPEND) + compact(rand_value(rng)) + compact(rand_value(rng)) +
+            rng.randbytes(ADDRESS_LENGTH) + compact(rand_value(rng)))
+
+
+def drain(rng):
+    return (header(rng, METHOD_DRAIN_VAULT) + compact(rand_value(rng)) + compact(rand_value(rng)) +
+            rng.randbytes(ADDRESS_LENGTH) + rng.randbytes(ADDRESS_LENGTH) + compact(rand_value(rng)))
+
+
+def write_seed(blob):
+    name = hashlib.sha1(blob).hexdigest()
+    with open(os.path.join(CORPUS_DIR, name), 'wb') as f:
+        f.write(blob)
+
+
+def main():
+    os.makedirs(CORPUS_DIR, exist_ok=True)
+
+    with open(TESTCASES) as f:
+        for testcase in json.load(f):
+            write_seed(bytes.fromhex(testcase['blob']))
+
+    rng = random.Random(0x5350)
+    builders = [lambda r: spawn(r, WALLET), lambda r: spawn(r, MULTISIG), lambda r: spawn(r, VESTING),
+                lambda r: spawn(r, VAULT), spend, drain]
+    for i in range(SYNTHETIC_COUNT):
+        write_seed(builders[i % len(builders)](rng))
+
+    print(f'Seed corpus written to {CORPUS_DIR}')
+
+
+if __name__ == '__main__':
+    main()
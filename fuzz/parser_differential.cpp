@@ -0,0 +1,115 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "parser.h"
+#include "reference_decoder.h"
+#include "zxformat.h"
+
+#ifdef NDEBUG
+#error "This fuzz target won't work correctly with NDEBUG defined, which will cause asserts to be eliminated"
+#endif
+
+// Differential target: parser_parse and the reference decoder must accept the same inputs and decode the same
+// values. Any mismatch is reported and aborts the run.
+
+using std::size_t;
+
+namespace {
+template <typename A, typename B>
+void expectEqual(const char *field, A actual, B expected) {
+    if (static_cast<uint64_t>(actual) != static_cast<uint64_t>(expected)) {
+        (void)fprintf(stderr, "%s mismatch: parser %llu, reference %llu\n", field, (unsigned long long)actual,
+                      (unsigned long long)expected);
+        assert(false);
+    }
+}
+
+void expectSamePtr(const char *field, const uint8_t *actual, const uint8_t *expected) {
+    if (actual != expected) {
+        (void)fprintf(stderr, "%s points to a different offset\n", field);
+        assert(false);
+    }
+}
+
+void compareSpawn(const parser_tx_t &tx, const reference::Spawn &ref) {
+    expectSamePtr("template", tx_accountTemplate(&tx), ref.accountTemplate.ptr);
+    expectEqual("nonce", tx.nonce, ref.nonce.value);
+    expectEqual("gas_price", tx.gas_price, ref.gasPrice.value);
+    expectEqual("account_type", tx.account_type, static_cast<uint8_t>(ref.account));
+
+    switch (ref.account) {
+        case reference::Account::Wallet:
+            expectSamePtr("wallet pubkey", tx_walletPubkey(&tx), ref.walletPubkey.ptr);
+            break;
+        case reference::Account::Multisig:
+        case reference::Account::Vesting:
+            expectEqual("approvers", tx.spawn.multisig.approvers, ref.approvers.value);
+            expectEqual("numberOfPubkeys", tx.spawn.multisig.numberOfPubkeys, ref.numPubkeys.value);
+            for (uint8_t i = 0; i < ref.numPubkeys.value; i++) {
+                expectSamePtr("pubkey", tx_multisigPubkey(&tx, i), ref.pubkeys[i].ptr);
+            }
+            break;
+        case reference::Account::Vault:
+            expectSamePtr("owner", tx_vaultOwner(&tx), ref.owner.ptr);
+            expectEqual("totalAmount", tx.spawn.vault.totalAmount, ref.totalAmount.value);
+            expectEqual("initialUnlockAmount", tx.spawn.vault.initialUnlockAmount, ref.initialUnlockAmount.value);
+            expectEqual("vestingStart", tx.spawn.vault.vestingStart, ref.vestingStart.value);
+            expectEqual("vestingEnd", tx.spawn.vault.vestingEnd, ref.vestingEnd.value);
+            break;
+    }
+}
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    // The parser context length is 16 bits wide
+    if (size > UINT16_MAX) {
+        return 0;
+    }
+
+    parser_tx_t txObj;
+    MEMZERO(&txObj, sizeof(txObj));
+    parser_context_t ctx;
+    const parser_error_t rc = parser_parse(&ctx, data, size, &txObj);
+
+    reference::Tx ref;
+    const bool refOk = reference::decodeTx(data, size, ref);
+
+    if ((rc == parser_ok) != refOk) {
+        (void)fprintf(stderr, "acceptance mismatch: parser %s, reference %s\n", parser_getErrorDescription(rc),
+                      refOk ? "accepted" : "rejected");
+        assert(false);
+    }
+    if (!refOk) {
+        return 0;
+    }
+
+    expectSamePtr("genesis", tx_genesisId(&txObj), ref.header.genesis.ptr);
+    expectSamePtr("principal", tx_principal(&txObj), ref.header.principal.ptr);
+    expectEqual("tx_version", txObj.tx_version, ref.header.version.value);
+    expectEqual("methodSelector", txObj.methodSelector, ref.header.selector.value);
+
+    switch (ref.header.selector.value) {
+        case reference::SELECTOR_SPAWN:
+            compareSpawn(txObj, ref.spawn);
+            break;
+        case reference::SELECTOR_SPEND:
+            expectEqual("nonce", txObj.nonce, ref.spend.nonce.value);
+            expectEqual("gas_price", txObj.gas_price, ref.spend.gasPrice.value);
+            expectSamePtr("destination", tx_spendDestination(&txObj), ref.spend.destination.ptr);
+            expectEqual("amount", txObj.spend.amount, ref.spend.amount.value);
+            break;
+        case reference::SELECTOR_DRAIN:
+            expectEqual("nonce", txObj.nonce, ref.drain.nonce.value);
+            expectEqual("gas_price", txObj.gas_price, ref.drain.gasPrice.value);
+            expectSamePtr("vault", tx_drainVault(&txObj), ref.drain.vault.ptr);
+            expectSamePtr("destination", tx_drainDestination(&txObj), ref.drain.destination.ptr);
+            expectEqual("amount", txObj.drain.amount, ref.drain.amount.value);
+            break;
+        default:
+            assert(false);
+    }
+
+    return 0;
+}
@@ -15,21 +15,20 @@ using std::size_t;
 namespace {
 char PARSER_KEY[16384];
 char PARSER_VALUE[16384];
-}  // namespace
 
-extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+void reviewMessage(const uint8_t *data, size_t size, uint8_t displayFlags) {
     parser_message_tx_t txObj;
     MEMZERO(&txObj, sizeof(txObj));
     parser_context_t ctx;
     parser_error_t rc;
 
-    rc = parser_message_parse(&ctx, data, size, &txObj);
+    rc = parser_message_parse_streamed(&ctx, data, size, &txObj, displayFlags, NULL);
     if (rc != parser_ok) {
-        return 0;
+        return;
     }
 
     uint8_t num_items;
-    rc = parser_message_getNumItems(&num_items);
+    rc = parser_message_getNumItems(&ctx, &num_items);
     if (rc != parser_ok) {
         assert(false);
     }
@@ -52,6 +51,11 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
             page_idx += 1;
         }
     }
+}
+}  // namespace
 
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    reviewMessage(data, size, 0);
+    reviewMessage(data, size, DISPLAY_FLAG_MESSAGE_DIGEST);
     return 0;
 }
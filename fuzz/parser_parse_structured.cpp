@@ -0,0 +1,596 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "parser.h"
+#include "zxformat.h"
+
+#ifdef NDEBUG
+#error "This fuzz target won't work correctly with NDEBUG defined, which will cause asserts to be eliminated"
+#endif
+
+// Structure-aware fuzzer for the tx parser.
+//
+// Inputs are plain serialized transactions, so crashes reproduce with the raw parser_parse target. The custom
+// mutator decodes the input following the spawn/spend/drain grammar, mutates one field (value, compact-int
+// encoding, account type, key count, ...) and serializes it again, so most mutants get past the header checks
+// and reach the multisig/vault branches and the display code. Inputs that do not decode are replaced by a
+// freshly generated transaction or handed to the default libFuzzer mutator.
+
+using std::size_t;
+
+extern "C" size_t LLVMFuzzerMutate(uint8_t *data, size_t size, size_t maxSize);
+
+namespace {
+char PARSER_KEY[64];
+char PARSER_VALUE[64];
+char CACHED_KEY[64];
+char CACHED_VALUE[64];
+
+// Small page width so multi-page items and page boundaries get exercised
+constexpr uint16_t VALUE_LEN = 21;
+
+enum class CompactMode : uint8_t { Single = 0, Two = 1, Four = 2, Big = 3 };
+
+enum class Role : uint8_t {
+    Genesis,
+    Version,
+    Principal,
+    Selector,
+    Template,
+    Nonce,
+    GasPrice,
+    Pubkey,
+    Approvers,
+    NumPubkeys,
+    Owner,
+    TotalAmount,
+    InitialUnlock,
+    VestingStart,
+    VestingEnd,
+    Destination,
+    Vault,
+    Amount,
+    Trailing,
+};
+
+struct Field {
+    Role role;
+    bool compact;
+    uint64_t value;
+    CompactMode mode;
+    std::vector<uint8_t> bytes;
+};
+
+using Tx = std::vector<Field>;
+
+const uint64_t INTERESTING_VALUES[] = {0,
+                                       1,
+                                       2,
+                                       9,
+                                       10,
+                                       11,
+                                       63,
+                                       64,
+                                       255,
+                                       256,
+                                       16383,
+                                       16384,
+                                       (1ULL << 30) - 1,
+                                       1ULL << 30,
+                                       (1ULL << 32) - 1,
+                                       1ULL << 32,
+                                       1000000000ULL,
+                                       4611686018427387903ULL,
+                                       4611686018427387904ULL,
+                                       UINT64_MAX};
+
+CompactMode minimalMode(uint64_t value) {
+    if (value < (1ULL << 6)) {
+        return CompactMode::Single;
+    }
+    if (value < (1ULL << 14)) {
+        return CompactMode::Two;
+    }
+    if (value < (1ULL << 30)) {
+        return CompactMode::Four;
+    }
+    return CompactMode::Big;
+}
+
+uint8_t bigintLength(uint64_t value) {
+    uint8_t len = 4;
+    while (len < 8 && (value >> (8 * len)) != 0) {
+        len++;
+    }
+    return len;
+}
+
+void encodeCompact(std::vector<uint8_t> &out, uint64_t value, CompactMode mode) {
+    // A mode too small for the value falls back to the minimal one
+    if (static_cast<uint8_t>(mode) < static_cast<uint8_t>(minimalMode(value))) {
+        mode = minimalMode(value);
+    }
+    switch (mode) {
+        case CompactMode::Single:
+            out.push_back(static_cast<uint8_t>(value << 2));
+            break;
+        case CompactMode::Two: {
+            const uint16_t v = static_cast<uint16_t>((value << 2) | 0x01);
+            out.push_back(static_cast<uint8_t>(v));
+            out.push_back(static_cast<uint8_t>(v >> 8));
+            break;
+        }
+        case CompactMode::Four: {
+            const uint32_t v = static_cast<uint32_t>((value << 2) | 0x02);
+            for (int i = 0; i < 4; i++) {
+                out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+            }
+            break;
+        }
+        case CompactMode::Big: {
+            const uint8_t len = bigintLength(value);
+            out.push_back(static_cast<uint8_t>(((len - 4) << 2) | 0x03));
+            for (uint8_t i = 0; i < len; i++) {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+            break;
+        }
+    }
+}
+
+class Reader {
+   public:
+    Reader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    bool fixed(Tx &tx, Role role, size_t len) {
+        if (size_ - offset_ < len) {
+            return false;
+        }
+        tx.push_back(
+            Field{role, false, 0, CompactMode::Single, std::vector<uint8_t>(data_ + offset_, data_ + offset_ + len)});
+        offset_ += len;
+        return true;
+    }
+
+    bool compact(Tx &tx, Role role) {
+        if (offset_ >= size_) {
+            return false;
+        }
+        const auto mode = static_cast<CompactMode>(data_[offset_] & 0x03);
+        size_t len = 1;
+        switch (mode) {
+            case CompactMode::Single:
+                len = 1;
+                break;
+            case CompactMode::Two:
+                len = 2;
+                break;
+            case CompactMode::Four:
+                len = 4;
+                break;
+            case CompactMode::Big:
+                len = 1 + (data_[offset_] >> 2) + 4;
+                break;
+        }
+        if (size_ - offset_ < len || (mode == CompactMode::Big && len > 9)) {
+            return false;
+        }
+
+        uint64_t value = 0;
+        if (mode == CompactMode::Big) {
+            for (size_t i = len - 1; i >= 1; i--) {
+                value = (value << 8) | data_[offset_ + i];
+            }
+        } else {
+            for (size_t i = len; i > 0; i--) {
+                value = (value << 8) | data_[offset_ + i - 1];
+            }
+            value >>= 2;
+        }
+        tx.push_back(Field{role, true, value, mode, {}});
+        offset_ += len;
+        return true;
+    }
+
+    size_t remaining() const { return size_ - offset_; }
+    const uint8_t *current() const { return data_ + offset_; }
+
+   private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+uint64_t fieldValue(const Tx &tx, Role role) {
+    for (const auto &f : tx) {
+        if (f.role == role) {
+            return f.value;
+        }
+    }
+    return 0;
+}
+
+// Decodes the tx following the parser grammar, without its value checks
+bool decodeTx(const uint8_t *data, size_t size, Tx &tx) {
+    Reader r(data, size);
+    tx.clear();
+
+    if (!r.fixed(tx, Role::Genesis, GENESIS_LENGTH) || !r.compact(tx, Role::Version) ||
+        !r.fixed(tx, Role::Principal, ADDRESS_LENGTH) || !r.compact(tx, Role::Selector)) {
+        return false;
+    }
+
+    switch (fieldValue(tx, Role::Selector)) {
+        case METHOD_SPAWN: {
+            if (!r.fixed(tx, Role::Template, ADDRESS_LENGTH) || !r.compact(tx, Role::Nonce) ||
+                !r.compact(tx, Role::GasPrice)) {
+                return false;
+            }
+            const uint8_t accountType = tx[tx.size() - 3].bytes.back();
+            switch (accountType) {
+                case WALLET:
+                    if (!r.fixed(tx, Role::Pubkey, PUB_KEY_LENGTH)) {
+                        return false;
+                    }
+                    break;
+                case MULTISIG:
+                case VESTING: {
+                    if (!r.compact(tx, Role::Approvers) || !r.compact(tx, Role::NumPubkeys)) {
+                        return false;
+                    }
+                    const uint64_t numPubkeys = tx.back().value;
+                    for (uint64_t i = 0; i < numPubkeys && i < MAX_MULTISIG_PUB_KEY + 1; i++) {
+                        if (!r.fixed(tx, Role::Pubkey, PUB_KEY_LENGTH)) {
+                            return false;
+                        }
+                    }
+                    break;
+                }
+                case VAULT:
+                    if (!r.fixed(tx, Role::Owner, ADDRESS_LENGTH) || !r.compact(tx, Role::TotalAmount) ||
+                        !r.compact(tx, Role::InitialUnlock) || !r.compact(tx, Role::VestingStart) ||
+                        !r.compact(tx, Role::VestingEnd)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        case METHOD_SPEND:
+            if (!r.compact(tx, Role::Nonce) || !r.compact(tx, Role::GasPrice) ||
+                !r.fixed(tx, Role::Destination, ADDRESS_LENGTH) || !r.compact(tx, Role::Amount)) {
+                return false;
+            }
+            break;
+        case METHOD_DRAIN_VAULT:
+            if (!r.compact(tx, Role::Nonce) || !r.compact(tx, Role::GasPrice) || !r.fixed(tx, Role::Vault, ADDRESS_LENGTH) ||
+                !r.fixed(tx, Role::Destination, ADDRESS_LENGTH) || !r.compact(tx, Role::Amount)) {
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (r.remaining() > 0) {
+        tx.push_back(Field{Role::Trailing, false, 0, CompactMode::Single,
+                           std::vector<uint8_t>(r.current(), r.current() + r.remaining())});
+    }
+    return true;
+}
+
+std::vector<uint8_t> encodeTx(const Tx &tx) {
+    std::vector<uint8_t> out;
+    for (const auto &f : tx) {
+        if (f.compact) {
+            encodeCompact(out, f.value, f.mode);
+        } else {
+            out.insert(out.end(), f.bytes.begin(), f.bytes.end());
+        }
+    }
+    return out;
+}
+
+template <typename Rng>
+std::vector<uint8_t> randomBytes(Rng &rng, size_t len) {
+    std::vector<uint8_t> bytes(len);
+    for (auto &b : bytes) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return bytes;
+}
+
+template <typename Rng>
+uint64_t randomValue(Rng &rng) {
+    switch (rng() % 3) {
+        case 0:
+            return INTERESTING_VALUES[rng() % (sizeof(INTERESTING_VALUES) / sizeof(INTERESTING_VALUES[0]))];
+        case 1:
+            return rng() % 1024;
+        default:
+            return (static_cast<uint64_t>(rng()) << 32 | rng()) >> (rng() % 64);
+    }
+}
+
+template <typename Rng>
+Field compactField(Rng &rng, Role role, uint64_t value) {
+    // Mostly minimal encodings, sometimes a wider (non-canonical) one
+    CompactMode mode = minimalMode(value);
+    if (rng() % 8 == 0) {
+        mode = static_cast<CompactMode>(rng() % 4);
+    }
+    return Field{role, true, value, mode, {}};
+}
+
+template <typename Rng>
+Field fixedField(Rng &rng, Role role, size_t len) {
+    return Field{role, false, 0, CompactMode::Single, randomBytes(rng, len)};
+}
+
+template <typename Rng>
+void appendPubkeys(Rng &rng, Tx &tx, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        tx.push_back(fixedField(rng, Role::Pubkey, PUB_KEY_LENGTH));
+    }
+}
+
+template <typename Rng>
+Tx generateTx(Rng &rng) {
+    Tx tx;
+    tx.push_back(fixedField(rng, Role::Genesis, GENESIS_LENGTH));
+    tx.push_back(compactField(rng, Role::Version, TX_VERSION));
+    tx.push_back(fixedField(rng, Role::Principal, ADDRESS_LENGTH));
+
+    const uint8_t selectors[] = {METHOD_SPAWN, METHOD_SPEND, METHOD_DRAIN_VAULT};
+    const uint8_t selector = selectors[rng() % 3];
+    tx.push_back(compactField(rng, Role::Selector, selector));
+
+    switch (selector) {
+        case METHOD_SPAWN: {
+            const uint8_t accountType = static_cast<uint8_t>(WALLET + rng() % 4);
+            Field templ = fixedField(rng, Role::Template, ADDRESS_LENGTH);
+            templ.bytes.back() = accountType;
+            tx.push_back(templ);
+            tx.push_back(compactField(rng, Role::Nonce, randomValue(rng)));
+            tx.push_back(compactField(rng, Role::GasPrice, randomValue(rng)));
+            switch (accountType) {
+                case WALLET:
+                    appendPubkeys(rng, tx, 1);
+                    break;
+                case MULTISIG:
+                case VESTING: {
+                    const uint64_t numPubkeys = 1 + rng() % MAX_MULTISIG_PUB_KEY;
+                    tx.push_back(compactField(rng, Role::Approvers, 1 + rng() % numPubkeys));
+                    tx.push_back(compactField(rng, Role::NumPubkeys, numPubkeys));
+                    appendPubkeys(rng, tx, numPubkeys);
+                    break;
+                }
+                default: {
+                    const uint64_t total = randomValue(rng);
+                    const uint64_t unlock = randomValue(rng);
+                    const uint64_t start = rng() % 100000;
+                    tx.push_back(fixedField(rng, Role::Owner, ADDRESS_LENGTH));
+                    tx.push_back(compactField(rng, Role::TotalAmount, total));
+                    tx.push_back(compactField(rng, Role::InitialUnlock, unlock <= total ? unlock : unlock % (total + 1)));
+                    tx.push_back(compactField(rng, Role::VestingStart, start));
+                    tx.push_back(compactField(rng, Role::VestingEnd, start + rng() % 100000));
+                    break;
+                }
+            }
+            break;
+        }
+        case METHOD_SPEND:
+            tx.push_back(compactField(rng, Role::Nonce, randomValue(rng)));
+            tx.push_back(compactField(rng, Role::GasPrice, randomValue(rng)));
+            tx.push_back(fixedField(rng, Role::Destination, ADDRESS_LENGTH));
+            tx.push_back(compactField(rng, Role::Amount, randomValue(rng)));
+            break;
+        default:
+            tx.push_back(compactField(rng, Role::Nonce, randomValue(rng)));
+            tx.push_back(compactField(rng, Role::GasPrice, randomValue(rng)));
+            tx.push_back(fixedField(rng, Role::Vault, ADDRESS_LENGTH));
+            tx.push_back(fixedField(rng, Role::Destination, ADDRESS_LENGTH));
+            tx.push_back(compactField(rng, Role::Amount, randomValue(rng)));
+            break;
+    }
+    return tx;
+}
+
+// Keeps the pubkey list consistent with a new key count
+template <typename Rng>
+void resizePubkeys(Rng &rng, Tx &tx, uint64_t count) {
+    size_t first = tx.size();
+    size_t current = 0;
+    for (size_t i = 0; i < tx.size(); i++) {
+        if (tx[i].role == Role::Pubkey) {
+            first = first == tx.size() ? i : first;
+            current++;
+        }
+    }
+    if (first == tx.size()) {
+        return;
+    }
+    while (current > count) {
+        tx.erase(tx.begin() + static_cast<long>(first));
+        current--;
+    }
+    while (current < count) {
+        tx.insert(tx.begin() + static_cast<long>(first), fixedField(rng, Role::Pubkey, PUB_KEY_LENGTH));
+        current++;
+    }
+}
+
+template <typename Rng>
+void mutateTx(Rng &rng, Tx &tx) {
+    Field &f = tx[rng() % tx.size()];
+
+    switch (rng() % 8) {
+        case 0:
+            // Switch transaction kind, the rest of the fields are regenerated
+            tx = generateTx(rng);
+            return;
+        case 1:
+            // Change the account type in the template, keeps the payload of the previous type
+            for (auto &t : tx) {
+                if (t.role == Role::Template) {
+                    t.bytes.back() = static_cast<uint8_t>(rng() % 6);
+                }
+            }
+            return;
+        case 2:
+            // Change key count, keeping the pubkey list in sync most of the time
+            for (auto &t : tx) {
+                if (t.role == Role::NumPubkeys || t.role == Role::Approvers) {
+                    t.value = rng() % (MAX_MULTISIG_PUB_KEY + 3);
+                    if (t.role == Role::NumPubkeys && rng() % 4 != 0) {
+                        resizePubkeys(rng, tx, t.value);
+                    }
+                    return;
+                }
+            }
+            return;
+        case 3:
+            // Re-encode a compact value with another mode, including non-canonical ones
+            if (f.compact) {
+                f.mode = static_cast<CompactMode>(rng() % 4);
+            }
+            return;
+        case 4:
+            if (f.compact) {
+                f.value = randomValue(rng);
+            } else if (!f.bytes.empty()) {
+                f.bytes[rng() % f.bytes.size()] ^= static_cast<uint8_t>(1 + rng() % 255);
+            }
+            return;
+        case 5:
+            // Vault bounds around the checks done by the parser
+            for (auto &t : tx) {
+                if (t.role == Role::InitialUnlock) {
+                    t.value = fieldValue(tx, Role::TotalAmount) + (rng() % 3) - 1;
+                } else if (t.role == Role::VestingEnd) {
+                    t.value = fieldValue(tx, Role::VestingStart) + (rng() % 3) - 1;
+                }
+            }
+            return;
+        case 6:
+            // Truncate or append trailing bytes
+            if (rng() % 2 == 0 && tx.size() > 1) {
+                tx.pop_back();
+            } else {
+                tx.push_back(fixedField(rng, Role::Trailing, 1 + rng() % 8));
+            }
+            return;
+        default:
+            if (!f.compact && !f.bytes.empty()) {
+                f.bytes = randomBytes(rng, f.bytes.size());
+            } else {
+                f.value = INTERESTING_VALUES[rng() % (sizeof(INTERESTING_VALUES) / sizeof(INTERESTING_VALUES[0]))];
+            }
+            return;
+    }
+}
+
+void checkItems(parser_context_t *ctx) {
+    uint8_t numItems = 0;
+    parser_error_t rc = parser_getNumItems(ctx, &numItems);
+    assert(rc == parser_ok);
+
+    for (uint8_t i = 0; i < numItems; i += 1) {
+        uint8_t pageIdx = 0;
+        uint8_t pageCount = 1;
+        while (pageIdx < pageCount) {
+            parser_display_cache_t *cache = ctx->cache;
+
+            // Rendered without cache, then through the cache: both must match
+            ctx->cache = nullptr;
+            uint8_t directPageCount = 0;
+            rc = parser_getItem(ctx, i, PARSER_KEY, sizeof(PARSER_KEY), PARSER_VALUE, VALUE_LEN, pageIdx, &directPageCount);
+            ctx->cache = cache;
+            if (rc != parser_ok) {
+                (void)fprintf(stderr, "error getting item %u at page index %u: %s\n", (unsigned)i, (unsigned)pageIdx,
+                              parser_getErrorDescription(rc));
+                assert(false);
+            }
+
+            rc = parser_getItem(ctx, i, CACHED_KEY, sizeof(CACHED_KEY), CACHED_VALUE, VALUE_LEN, pageIdx, &pageCount);
+            assert(rc == parser_ok);
+            assert(pageCount == directPageCount);
+            assert(strcmp(PARSER_KEY, CACHED_KEY) == 0);
+            assert(strcmp(PARSER_VALUE, CACHED_VALUE) == 0);
+
+            pageIdx += 1;
+        }
+    }
+}
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    parser_tx_t txObj;
+    MEMZERO(&txObj, sizeof(txObj));
+    parser_context_t ctx;
+    parser_display_cache_t cache;
+
+    parser_error_t rc = parser_parse(&ctx, data, size, &txObj);
+    if (rc != parser_ok) {
+        return 0;
+    }
+
+    for (uint8_t displayFlags = 0; displayFlags <= DISPLAY_FLAG_COMPACT; displayFlags++) {
+        for (const bool expert : {false, true}) {
+            ctx.expert = expert;
+            ctx.displayFlags = displayFlags;
+            parser_attach_cache(&ctx, &cache);
+
+            rc = parser_validate(&ctx);
+            if (rc != parser_ok) {
+                return 0;
+            }
+            checkItems(&ctx);
+
+            // The normal review is the start of the expert one
+            uint8_t numItems = 0;
+            uint8_t numItemsExpert = 0;
+            rc = parser_getNumItemsBothModes(&ctx, &numItems, &numItemsExpert);
+            assert(rc == parser_ok && numItems <= numItemsExpert);
+        }
+    }
+
+    return 0;
+}
+
+extern "C" size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t size, size_t maxSize, unsigned int seed) {
+    std::minstd_rand rng(seed);
+
+    Tx tx;
+    if (!decodeTx(data, size, tx) || tx.empty()) {
+        if (rng() % 4 == 0) {
+            return LLVMFuzzerMutate(data, size, maxSize);
+        }
+        tx = generateTx(rng);
+    } else {
+        const unsigned rounds = 1 + rng() % 3;
+        for (unsigned i = 0; i < rounds && !tx.empty(); i++) {
+            mutateTx(rng, tx);
+        }
+    }
+
+    std::vector<uint8_t> out = encodeTx(tx);
+    if (out.empty() || out.size() > maxSize) {
+        return LLVMFuzzerMutate(data, size, maxSize);
+    }
+    memcpy(data, out.data(), out.size());
+
+    // Occasionally let libFuzzer corrupt the well-formed tx at byte level
+    if (rng() % 16 == 0) {
+        return LLVMFuzzerMutate(data, out.size(), maxSize);
+    }
+    return out.size();
+}
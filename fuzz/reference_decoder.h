@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Reference decoder for Spacemesh transactions, used only by the differential fuzzer.
+//
+// Written from the SCALE spec rather than from the C parser: compact integers must use the shortest mode and,
+// in big-integer mode, the shortest length. Values above 2^62 - 1 are rejected, as the app does.
+
+namespace reference {
+
+constexpr size_t GENESIS_LEN = 20;
+constexpr size_t ADDRESS_LEN = 24;
+constexpr size_t PUBKEY_LEN = 32;
+constexpr uint8_t MAX_KEYS = 10;
+constexpr uint64_t MAX_COMPACT = (1ULL << 62) - 1;
+
+constexpr uint8_t SELECTOR_SPAWN = 0;
+constexpr uint8_t SELECTOR_SPEND = 16;
+constexpr uint8_t SELECTOR_DRAIN = 17;
+
+enum class Account : uint8_t { Wallet = 1, Multisig = 2, Vesting = 3, Vault = 4 };
+
+struct Cursor {
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+
+    size_t remaining() const { return size - offset; }
+};
+
+template <size_t N>
+struct Fixed {
+    const uint8_t *ptr = nullptr;
+};
+
+template <typename T>
+struct Compact {
+    T value = 0;
+};
+
+template <size_t N>
+bool decode(Cursor &c, Fixed<N> &out) {
+    if (c.remaining() < N) {
+        return false;
+    }
+    out.ptr = c.data + c.offset;
+    c.offset += N;
+    return true;
+}
+
+inline bool decodeCompact(Cursor &c, uint64_t &value) {
+    if (c.remaining() < 1) {
+        return false;
+    }
+    const uint8_t first = c.data[c.offset];
+
+    size_t len = 0;
+    uint64_t minimum = 0;
+    switch (first & 0x03) {
+        case 0:
+            len = 1;
+            break;
+        case 1:
+            len = 2;
+            minimum = 1ULL << 6;
+            break;
+        case 2:
+            len = 4;
+            minimum = 1ULL << 14;
+            break;
+        default:
+            len = 1 + 4 + (first >> 2);
+            minimum = 1ULL << 30;
+            break;
+    }
+    if (c.remaining() < len) {
+        return false;
+    }
+
+    value = 0;
+    if ((first & 0x03) == 0x03) {
+        const size_t bytes = len - 1;
+        if (bytes > sizeof(uint64_t) || c.data[c.offset + bytes] == 0) {
+            return false;
+        }
+        for (size_t i = bytes; i >= 1; i--) {
+            value = (value << 8) | c.data[c.offset + i];
+        }
+    } else {
+        for (size_t i = len; i >= 1; i--) {
+            value = (value << 8) | c.data[c.offset + i - 1];
+        }
+        value >>= 2;
+    }
+
+    if (value < minimum || value > MAX_COMPACT) {
+        return false;
+    }
+    c.offset += len;
+    return true;
+}
+
+template <typename T>
+bool decode(Cursor &c, Compact<T> &out) {
+    uint64_t value = 0;
+    if (!decodeCompact(c, value) || value > std::numeric_limits<T>::max()) {
+        return false;
+    }
+    out.value = static_cast<T>(value);
+    return true;
+}
+
+template <typename... Fields>
+bool decodeFields(Cursor &c, Fields &...fields) {
+    return (decode(c, fields) && ...);
+}
+
+struct Header {
+    Fixed<GENESIS_LEN> genesis;
+    Compact<uint8_t> version;
+    Fixed<ADDRESS_LEN> principal;
+    Compact<uint8_t> selector;
+};
+
+struct Spawn {
+    Fixed<ADDRESS_LEN> accountTemplate;
+    Compact<uint64_t> nonce;
+    Compact<uint64_t> gasPrice;
+    Account account = Account::Wallet;
+
+    Fixed<PUBKEY_LEN> walletPubkey;
+
+    Compact<uint8_t> approvers;
+    Compact<uint8_t> numPubkeys;
+    Fixed<PUBKEY_LEN> pubkeys[MAX_KEYS];
+
+    Fixed<ADDRESS_LEN> owner;
+    Compact<uint64_t> totalAmount;
+    Compact<uint64_t> initialUnlockAmount;
+    Compact<uint32_t> vestingStart;
+    Compact<uint32_t> vestingEnd;
+};
+
+struct Spend {
+    Compact<uint64_t> nonce;
+    Compact<uint64_t> gasPrice;
+    Fixed<ADDRESS_LEN> destination;
+    Compact<uint64_t> amount;
+};
+
+struct Drain {
+    Compact<uint64_t> nonce;
+    Compact<uint64_t> gasPrice;
+    Fixed<ADDRESS_LEN> vault;
+    Fixed<ADDRESS_LEN> destination;
+    Compact<uint64_t> amount;
+};
+
+struct Tx {
+    Header header;
+    Spawn spawn;
+    Spend spend;
+    Drain drain;
+};
+
+inline bool decodeSpawn(Cursor &c, Spawn &s) {
+    if (!decodeFields(c, s.accountTemplate, s.nonce, s.gasPrice)) {
+        return false;
+    }
+
+    const uint8_t account = s.accountTemplate.ptr[ADDRESS_LEN - 1];
+    switch (account) {
+        case static_cast<uint8_t>(Account::Wallet):
+            s.account = Account::Wallet;
+            return decode(c, s.walletPubkey);
+        case static_cast<uint8_t>(Account::Multisig):
+        case static_cast<uint8_t>(Account::Vesting):
+            s.account = static_cast<Account>(account);
+            if (!decode(c, s.approvers) || s.approvers.value > MAX_KEYS) {
+                return false;
+            }
+            if (!decode(c, s.numPubkeys) || s.numPubkeys.value < s.approvers.value || s.numPubkeys.value > MAX_KEYS) {
+                return false;
+            }
+            for (uint8_t i = 0; i < s.numPubkeys.value; i++) {
+                if (!decode(c, s.pubkeys[i])) {
+                    return false;
+                }
+            }
+            return true;
+        case static_cast<uint8_t>(Account::Vault):
+            s.account = Account::Vault;
+            if (!decodeFields(c, s.owner, s.totalAmount, s.initialUnlockAmount)) {
+                return false;
+            }
+            if (s.initialUnlockAmount.value > s.totalAmount.value) {
+                return false;
+            }
+            return decodeFields(c, s.vestingStart, s.vestingEnd) && s.vestingStart.value <= s.vestingEnd.value;
+        default:
+            return false;
+    }
+}
+
+inline bool decodeTx(const uint8_t *data, size_t size, Tx &tx) {
+    Cursor c{data, size, 0};
+
+    Header &h = tx.header;
+    if (!decodeFields(c, h.genesis, h.version, h.principal, h.selector) || h.version.value != 0) {
+        return false;
+    }
+
+    bool ok = false;
+    switch (h.selector.value) {
+        case SELECTOR_SPAWN:
+            ok = decodeSpawn(c, tx.spawn);
+            break;
+        case SELECTOR_SPEND:
+            ok = decodeFields(c, tx.spend.nonce, tx.spend.gasPrice, tx.spend.destination, tx.spend.amount);
+            break;
+        case SELECTOR_DRAIN:
+            ok = decodeFields(c, tx.drain.nonce, tx.drain.gasPrice, tx.drain.vault, tx.drain.destination, tx.drain.amount);
+            break;
+        default:
+            return false;
+    }
+
+    return ok && c.remaining() == 0;
+}
+
+}  // namespace reference
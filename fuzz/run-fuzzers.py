@@ -11,7 +11,10 @@ MUTATE_DEPTH = random.randint(1, 20)
 # (fuzzer name, max length, max time scale factor)
 CONFIGS = [
     ('parser_parse', 17000, 4),
+    ('parser_parse_structured', 17000, 4),
+    ('parser_differential', 17000, 2),
     ('parser_message_parse', 17000, 4),
+    ('address_request', 512, 2),
 ]
 
 for config in CONFIGS:
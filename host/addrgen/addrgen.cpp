@@ -0,0 +1,346 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "addrgen.h"
+
+#include <json/json.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include "bech32.h"
+
+namespace addrgen {
+
+namespace {
+constexpr size_t LINES_PER_THREAD = 4096;
+constexpr size_t VAULT_TERMS = 4;
+
+bool fail(std::string *error, const char *message) {
+    *error = message;
+    return false;
+}
+
+int8_t hexNibble(char c) {
+    if (c >= '0' && c <= '9') {
+        return static_cast<int8_t>(c - '0');
+    }
+    if (c >= 'a' && c <= 'f') {
+        return static_cast<int8_t>(c - 'a' + 10);
+    }
+    if (c >= 'A' && c <= 'F') {
+        return static_cast<int8_t>(c - 'A' + 10);
+    }
+    return -1;
+}
+
+bool parsePubkey(const std::string &hex, Pubkey *out) {
+    if (hex.size() != 2 * out->size()) {
+        return false;
+    }
+    for (size_t i = 0; i < out->size(); i++) {
+        const int8_t hi = hexNibble(hex[2 * i]);
+        const int8_t lo = hexNibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        (*out)[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+bool parseUint(const std::string &text, uint64_t max, uint64_t *out) {
+    const auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+    if (text.empty() || text.size() > 20 || !std::all_of(text.begin(), text.end(), isDigit)) {
+        return false;
+    }
+    errno = 0;
+    *out = strtoull(text.c_str(), nullptr, 10);
+    return errno == 0 && *out <= max;
+}
+
+bool parseType(const std::string &text, account_type_e *type) {
+    if (text == "wallet") {
+        *type = WALLET;
+    } else if (text == "multisig") {
+        *type = MULTISIG;
+    } else if (text == "vesting") {
+        *type = VESTING;
+    } else if (text == "vault") {
+        *type = VAULT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseNetwork(const std::string &text, bool *mainnet) {
+    if (text != "mainnet" && text != "testnet") {
+        return false;
+    }
+    *mainnet = text == "mainnet";
+    return true;
+}
+
+std::vector<std::string> split(const std::string &text, char separator) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        const size_t end = text.find(separator, start);
+        fields.push_back(text.substr(start, end - start));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+
+// Type, network and keys are set, checks the remaining fields agree with them
+bool validate(const AccountSpec &spec, std::string *error) {
+    if (spec.pubkeys.empty() || spec.pubkeys.size() > MAX_MULTISIG_PUB_KEY) {
+        return fail(error, "invalid number of pubkeys");
+    }
+    if (spec.type == WALLET) {
+        return spec.pubkeys.size() == 1 || fail(error, "wallet accounts have a single pubkey");
+    }
+    if (spec.approvers == 0 || spec.approvers > spec.pubkeys.size()) {
+        return fail(error, "invalid number of approvers");
+    }
+    return true;
+}
+
+bool parseCsv(const std::string &line, AccountSpec *spec, std::string *error) {
+    const std::vector<std::string> fields = split(line, ',');
+    if (fields.size() < 4) {
+        return fail(error, "expected type,network,approvers,pubkeys");
+    }
+    if (!parseType(fields[0], &spec->type)) {
+        return fail(error, "invalid account type");
+    }
+    if (!parseNetwork(fields[1], &spec->mainnet)) {
+        return fail(error, "invalid network");
+    }
+    if (fields.size() != (spec->type == VAULT ? 4 + VAULT_TERMS : 4)) {
+        return fail(error, "unexpected number of fields");
+    }
+
+    uint64_t value = 0;
+    if (spec->type != WALLET) {
+        if (!parseUint(fields[2], MAX_MULTISIG_PUB_KEY, &value)) {
+            return fail(error, "invalid number of approvers");
+        }
+        spec->approvers = static_cast<uint8_t>(value);
+    }
+
+    for (const auto &hex : split(fields[3], ';')) {
+        Pubkey pubkey{};
+        if (!parsePubkey(hex, &pubkey)) {
+            return fail(error, "invalid pubkey");
+        }
+        spec->pubkeys.push_back(pubkey);
+    }
+
+    if (spec->type == VAULT) {
+        uint64_t start = 0;
+        uint64_t end = 0;
+        if (!parseUint(fields[4], UINT64_MAX, &spec->totalAmount) ||
+            !parseUint(fields[5], UINT64_MAX, &spec->initialUnlockAmount) || !parseUint(fields[6], UINT32_MAX, &start) ||
+            !parseUint(fields[7], UINT32_MAX, &end)) {
+            return fail(error, "invalid vault terms");
+        }
+        spec->vestingStart = static_cast<uint32_t>(start);
+        spec->vestingEnd = static_cast<uint32_t>(end);
+    }
+    return validate(*spec, error);
+}
+
+bool jsonUint(const Json::Value &obj, const char *key, uint64_t max, uint64_t *out) {
+    const Json::Value &v = obj[key];
+    if (!v.isUInt64() || v.asUInt64() > max) {
+        return false;
+    }
+    *out = v.asUInt64();
+    return true;
+}
+
+bool parseJsonl(const std::string &line, AccountSpec *spec, std::string *error) {
+    // Each worker thread keeps its own reader
+    thread_local std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+
+    Json::Value obj;
+    if (!reader->parse(line.data(), line.data() + line.size(), &obj, nullptr) || !obj.isObject()) {
+        return fail(error, "invalid JSON");
+    }
+    if (!obj["type"].isString() || !parseType(obj["type"].asString(), &spec->type)) {
+        return fail(error, "invalid account type");
+    }
+    if (!obj["network"].isString() || !parseNetwork(obj["network"].asString(), &spec->mainnet)) {
+        return fail(error, "invalid network");
+    }
+
+    uint64_t value = 0;
+    if (spec->type != WALLET) {
+        if (!jsonUint(obj, "approvers", MAX_MULTISIG_PUB_KEY, &value)) {
+            return fail(error, "invalid number of approvers");
+        }
+        spec->approvers = static_cast<uint8_t>(value);
+    }
+
+    if (!obj["pubkeys"].isArray()) {
+        return fail(error, "invalid pubkey");
+    }
+    for (const auto &hex : obj["pubkeys"]) {
+        Pubkey pubkey{};
+        if (!hex.isString() || !parsePubkey(hex.asString(), &pubkey)) {
+            return fail(error, "invalid pubkey");
+        }
+        spec->pubkeys.push_back(pubkey);
+    }
+
+    if (spec->type == VAULT) {
+        uint64_t start = 0;
+        uint64_t end = 0;
+        if (!jsonUint(obj, "total_amount", UINT64_MAX, &spec->totalAmount) ||
+            !jsonUint(obj, "initial_unlock_amount", UINT64_MAX, &spec->initialUnlockAmount) ||
+            !jsonUint(obj, "vesting_start", UINT32_MAX, &start) || !jsonUint(obj, "vesting_end", UINT32_MAX, &end)) {
+            return fail(error, "invalid vault terms");
+        }
+        spec->vestingStart = static_cast<uint32_t>(start);
+        spec->vestingEnd = static_cast<uint32_t>(end);
+    }
+    return validate(*spec, error);
+}
+
+bool skipped(const std::string &line) { return line.empty() || line[0] == '#'; }
+
+void readBatch(std::istream &in, size_t maxLines, std::vector<std::string> *lines) {
+    lines->clear();
+    std::string line;
+    while (lines->size() < maxLines && std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!skipped(line)) {
+            lines->push_back(std::move(line));
+        }
+    }
+}
+}  // namespace
+
+bool parseSpec(const std::string &line, Format format, AccountSpec *spec, std::string *error) {
+    *spec = AccountSpec();
+    return format == Format::Csv ? parseCsv(line, spec, error) : parseJsonl(line, spec, error);
+}
+
+bool deriveAddress(const AccountSpec &spec, std::string *address, std::string *error) {
+    // The first key stands in for the device key at index 0, the others follow in order
+    pubkey_item_t internalPubkey{};
+    std::copy(spec.pubkeys[0].begin(), spec.pubkeys[0].end(), internalPubkey.pubkey);
+
+    generic_account_t account{};
+    vault_account_t vault{};
+    vault.owner = &account;
+    account.approvers = spec.approvers;
+    account.participants = static_cast<uint8_t>(spec.pubkeys.size());
+    for (size_t i = 1; i < spec.pubkeys.size(); i++) {
+        account.keys[i - 1].index = static_cast<uint8_t>(i);
+        std::copy(spec.pubkeys[i].begin(), spec.pubkeys[i].end(), account.keys[i - 1].pubkey);
+    }
+
+    // The encoders hash into the full buffer before moving the address to the front
+    uint8_t raw[MAX_ADDRESS_LENGTH] = {0};
+    zxerr_t err = zxerr_ok;
+    if (spec.type == VAULT) {
+        vault.totalAmount = spec.totalAmount;
+        vault.initialUnlockAmount = spec.initialUnlockAmount;
+        vault.vestingStart = spec.vestingStart;
+        vault.vestingEnd = spec.vestingEnd;
+        err = crypto_encodeVaultPubkey(raw, sizeof(raw), &internalPubkey, &vault);
+    } else {
+        err = crypto_encodeAccountPubkey(raw, sizeof(raw), &internalPubkey, &account, spec.type);
+    }
+    if (err != zxerr_ok) {
+        return fail(error, "address derivation failed");
+    }
+
+    char bech32[MAX_ADDRESS_LENGTH] = {0};
+    const char *hrp = calculate_hrp(spec.mainnet ? NETWORK_MAINNET : NETWORK_TESTNET);
+    if (bech32EncodeFromBytes(bech32, sizeof(bech32), hrp, raw, ADDRESS_LENGTH, 1, BECH32_ENCODING_BECH32) != zxerr_ok) {
+        return fail(error, "bech32 encoding failed");
+    }
+    *address = bech32;
+    return true;
+}
+
+std::string processLine(const std::string &line, Format format, bool *ok) {
+    AccountSpec spec;
+    std::string address;
+    std::string error;
+    *ok = parseSpec(line, format, &spec, &error) && deriveAddress(spec, &address, &error);
+
+    if (format == Format::Csv) {
+        return *ok ? address : "error: " + error;
+    }
+    // Addresses and error messages never need escaping
+    return *ok ? "{\"address\":\"" + address + "\"}" : "{\"error\":\"" + error + "\"}";
+}
+
+RunStats run(std::istream &in, std::ostream &out, Format format, size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    const size_t batchLines = LINES_PER_THREAD * threads;
+
+    RunStats stats;
+    std::vector<std::string> current;
+    std::vector<std::string> next;
+    readBatch(in, batchLines, &current);
+
+    while (!current.empty()) {
+        std::vector<std::string> results(current.size());
+        std::vector<uint8_t> ok(current.size(), 0);
+
+        // Contiguous slices, so each worker writes its own range of results
+        const size_t slice = (current.size() + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (size_t begin = 0; begin < current.size(); begin += slice) {
+            const size_t end = std::min(begin + slice, current.size());
+            workers.emplace_back([&, begin, end] {
+                for (size_t i = begin; i < end; i++) {
+                    bool lineOk = false;
+                    results[i] = processLine(current[i], format, &lineOk);
+                    ok[i] = lineOk ? 1 : 0;
+                }
+            });
+        }
+
+        readBatch(in, batchLines, &next);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        for (size_t i = 0; i < results.size(); i++) {
+            out << results[i] << '\n';
+            stats.errors += ok[i] ? 0 : 1;
+        }
+        stats.accounts += results.size();
+        current.swap(next);
+    }
+    out.flush();
+    return stats;
+}
+
+}  // namespace addrgen
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "crypto_helper.h"
+
+namespace addrgen {
+
+// One account per input line, blank lines and lines starting with '#' are skipped.
+//
+// CSV:    type,network,approvers,pubkeys[,total_amount,initial_unlock_amount,vesting_start,vesting_end]
+//         pubkeys are hex and separated by ';', the vault terms are only present for vault accounts
+// JSONL:  {"type": ..., "network": ..., "approvers": n, "pubkeys": [...], "total_amount": n, ...}
+//
+// type is wallet, multisig, vesting or vault, network is mainnet or testnet. The first pubkey takes the place of
+// the device key. For vault accounts the pubkeys and approvers describe the vesting owner.
+enum class Format : uint8_t { Csv, Jsonl };
+
+using Pubkey = std::array<uint8_t, PUB_KEY_LENGTH>;
+
+struct AccountSpec {
+    account_type_e type = UNKNOWN;
+    bool mainnet = true;
+    uint8_t approvers = 0;
+    std::vector<Pubkey> pubkeys;
+    uint64_t totalAmount = 0;
+    uint64_t initialUnlockAmount = 0;
+    uint32_t vestingStart = 0;
+    uint32_t vestingEnd = 0;
+};
+
+bool parseSpec(const std::string &line, Format format, AccountSpec *spec, std::string *error);
+
+// Bech32 address of the account. Safe to call from several threads.
+bool deriveAddress(const AccountSpec &spec, std::string *address, std::string *error);
+
+// Output line for one input line: the address in CSV mode, {"address": ...} in JSONL mode, or the error
+std::string processLine(const std::string &line, Format format, bool *ok);
+
+struct RunStats {
+    size_t accounts = 0;
+    size_t errors = 0;
+};
+
+// Streams accounts from in to out, one output line per account in input order. Batches of lines are derived on
+// worker threads while the next batch is read.
+RunStats run(std::istream &in, std::ostream &out, Format format, size_t threads);
+
+}  // namespace addrgen
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "addrgen.h"
+
+// addrgen [--format csv|jsonl] [--threads <n>] [--input <file>] [--output <file>]
+//
+// Derives the bech32 address of every account spec read from input (stdin by default), see addrgen.h for the
+// formats. Writes one line per account, in input order. Exits with failure if any account could not be derived.
+
+namespace {
+void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--format csv|jsonl] [--threads <n>] [--input <file>] [--output <file>]\n", argv0);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    addrgen::Format format = addrgen::Format::Csv;
+    size_t threads = std::thread::hardware_concurrency();
+    std::string inputPath;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name != "csv" && name != "jsonl") {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            format = name == "csv" ? addrgen::Format::Csv : addrgen::Format::Jsonl;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            inputPath = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ifstream inFile;
+    if (!inputPath.empty()) {
+        inFile.open(inputPath);
+        if (!inFile.is_open()) {
+            fprintf(stderr, "cannot read %s\n", inputPath.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    std::ofstream outFile;
+    if (!outputPath.empty()) {
+        outFile.open(outputPath, std::ios::trunc);
+        if (!outFile.is_open()) {
+            fprintf(stderr, "cannot write %s\n", outputPath.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::istream &in = inputPath.empty() ? std::cin : inFile;
+    std::ostream &out = outputPath.empty() ? std::cout : outFile;
+
+    const addrgen::RunStats stats = addrgen::run(in, out, format, threads);
+    if (!out.good()) {
+        fprintf(stderr, "write failed\n");
+        return EXIT_FAILURE;
+    }
+    if (stats.errors > 0) {
+        fprintf(stderr, "%zu of %zu accounts failed\n", stats.errors, stats.accounts);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
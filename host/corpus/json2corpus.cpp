@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <hexutils.h>
+#include <json/json.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "spacemesh/corpus.hpp"
+
+// json2corpus -o <out> [--tx <testcases.json>]... [--message <message_testcases.json>]...
+//
+// Builds a binary corpus (see spacemesh/corpus.hpp) from JSON test vectors.
+
+namespace {
+bool addJson(spacemesh::CorpusWriter *writer, const std::string &path, spacemesh::BlobType type) {
+    std::ifstream in(path);
+    Json::CharReaderBuilder builder;
+    Json::Value testcases;
+    JSONCPP_STRING errs;
+    if (!in.good() || !Json::parseFromStream(builder, in, &testcases, &errs)) {
+        fprintf(stderr, "cannot read %s: %s\n", path.c_str(), errs.c_str());
+        return false;
+    }
+
+    for (const auto &tc : testcases) {
+        const std::string hex = tc["blob"].asString();
+        std::vector<uint8_t> blob(hex.size() / 2);
+        if (parseHexString(blob.data(), blob.size(), hex.c_str()) != blob.size()) {
+            fprintf(stderr, "%s: invalid blob in %s\n", path.c_str(), tc["name"].asCString());
+            return false;
+        }
+
+        std::vector<std::string> output;
+        std::vector<std::string> outputExpert;
+        for (const auto &line : tc["output"]) {
+            output.push_back(line.asString());
+        }
+        for (const auto &line : tc["output_expert"]) {
+            outputExpert.push_back(line.asString());
+        }
+
+        uint8_t flags = 0;
+        flags |= tc.get("mainnet", true).asBool() ? spacemesh::CORPUS_FLAG_MAINNET : 0;
+        flags |= tc["compact"].asBool() ? spacemesh::CORPUS_FLAG_COMPACT : 0;
+        flags |= tc["digest"].asBool() ? spacemesh::CORPUS_FLAG_MESSAGE_DIGEST : 0;
+
+        try {
+            writer->add(type, flags, blob, tc["name"].asString(), spacemesh::hashOutput(output),
+                        spacemesh::hashOutput(outputExpert));
+        } catch (const spacemesh::Error &e) {
+            fprintf(stderr, "%s: cannot hash the output of %s: %s\n", path.c_str(), tc["name"].asCString(), e.what());
+            return false;
+        }
+    }
+    return true;
+}
+
+void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s -o <out> [--tx <file.json>]... [--message <file.json>]...\n", argv0);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string outPath;
+    spacemesh::CorpusWriter writer;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (strcmp(argv[i], "-o") == 0) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--tx") == 0) {
+            if (!addJson(&writer, argv[++i], spacemesh::BlobType::Tx)) {
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--message") == 0) {
+            if (!addJson(&writer, argv[++i], spacemesh::BlobType::Message)) {
+                return EXIT_FAILURE;
+            }
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (outPath.empty()) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<uint8_t> image = writer.finish();
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+    if (!out.good()) {
+        fprintf(stderr, "cannot write %s\n", outPath.c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,294 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+// Binary corpus of tx and message blobs with the hashes of their expected display output.
+//
+// Layout, integers little endian:
+//
+//   header   magic "SMCORPUS", version:u16, reserved:u16, count:u32, indexOffset:u64, dataOffset:u64   (32 bytes)
+//   index    count entries of 80 bytes at indexOffset:
+//              offset:u64 blobLen:u32 nameLen:u16 type:u8 flags:u8
+//              outputHash[32] expertHash[32]
+//   data     per entry, blob followed by name, at offset
+//
+// The hashes are BLAKE3-256 over the expected display lines, each followed by '\n', in the format of
+// tests/testcases.json. CorpusView validates the whole index when it is created; entries then hand out views
+// into the mapping without copying.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "blake3.h"
+#include "spacemesh/tx.hpp"
+
+namespace spacemesh {
+
+constexpr char CORPUS_MAGIC[8] = {'S', 'M', 'C', 'O', 'R', 'P', 'U', 'S'};
+constexpr uint16_t CORPUS_VERSION = 1;
+constexpr size_t CORPUS_HEADER_LEN = 32;
+constexpr size_t CORPUS_ENTRY_LEN = 80;
+constexpr size_t OUTPUT_HASH_LEN = 32;
+
+enum class BlobType : uint8_t { Tx = 0, Message = 1 };
+
+// Entry flags
+constexpr uint8_t CORPUS_FLAG_MAINNET = 0x01;
+constexpr uint8_t CORPUS_FLAG_COMPACT = 0x02;
+constexpr uint8_t CORPUS_FLAG_MESSAGE_DIGEST = 0x04;
+
+using OutputHash = std::array<uint8_t, OUTPUT_HASH_LEN>;
+
+// The vendored hasher keeps BLAKE3_MAX_DEPTH + 1 chaining values, which only covers inputs below 2^MAX_DEPTH chunks
+constexpr size_t OUTPUT_HASH_MAX_INPUT_LEN = (static_cast<size_t>(BLAKE3_CHUNK_LEN) << BLAKE3_MAX_DEPTH) - 1;
+
+// Throws Error(parser_value_out_of_range) if the lines, newlines included, exceed OUTPUT_HASH_MAX_INPUT_LEN bytes
+inline OutputHash hashOutput(const std::vector<std::string> &lines) {
+    size_t totalLen = 0;
+    for (const auto &line : lines) {
+        totalLen += line.size() + 1;
+    }
+    if (totalLen > OUTPUT_HASH_MAX_INPUT_LEN) {
+        throw Error(parser_value_out_of_range);
+    }
+
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    for (const auto &line : lines) {
+        blake3_hasher_update(&hasher, line.data(), line.size());
+        blake3_hasher_update(&hasher, "\n", 1);
+    }
+    OutputHash hash{};
+    blake3_hasher_finalize(&hasher, hash.data(), hash.size());
+    return hash;
+}
+
+namespace detail {
+inline uint64_t readLE(const uint8_t *p, size_t len) {
+    uint64_t v = 0;
+    for (size_t i = len; i > 0; i--) {
+        v = (v << 8) | p[i - 1];
+    }
+    return v;
+}
+
+inline void writeLE(std::vector<uint8_t> *out, uint64_t v, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        out->push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+}  // namespace detail
+
+class CorpusEntry {
+   public:
+    CorpusEntry(const uint8_t *base, const uint8_t *entry) noexcept : base_(base), entry_(entry) {}
+
+    ByteSpan blob() const noexcept { return ByteSpan(base_ + offset(), blobLen()); }
+    std::string_view name() const noexcept {
+        return std::string_view(reinterpret_cast<const char *>(base_ + offset() + blobLen()), nameLen());
+    }
+    BlobType type() const noexcept { return static_cast<BlobType>(entry_[14]); }
+    uint8_t flags() const noexcept { return entry_[15]; }
+    bool mainnet() const noexcept { return (flags() & CORPUS_FLAG_MAINNET) != 0; }
+    bool compact() const noexcept { return (flags() & CORPUS_FLAG_COMPACT) != 0; }
+    bool messageDigest() const noexcept { return (flags() & CORPUS_FLAG_MESSAGE_DIGEST) != 0; }
+    ByteSpan outputHash() const noexcept { return ByteSpan(entry_ + 16, OUTPUT_HASH_LEN); }
+    ByteSpan expertHash() const noexcept { return ByteSpan(entry_ + 16 + OUTPUT_HASH_LEN, OUTPUT_HASH_LEN); }
+
+   private:
+    uint64_t offset() const noexcept { return detail::readLE(entry_, 8); }
+    uint32_t blobLen() const noexcept { return static_cast<uint32_t>(detail::readLE(entry_ + 8, 4)); }
+    uint16_t nameLen() const noexcept { return static_cast<uint16_t>(detail::readLE(entry_ + 12, 2)); }
+
+    const uint8_t *base_;
+    const uint8_t *entry_;
+};
+
+// Read-only view of a corpus image, either mapped by CorpusFile or held by the caller
+class CorpusView {
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CorpusEntry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = CorpusEntry;
+
+        iterator(const CorpusView *view, uint32_t index) noexcept : view_(view), index_(index) {}
+        CorpusEntry operator*() const noexcept { return (*view_)[index_]; }
+        iterator &operator++() noexcept {
+            index_++;
+            return *this;
+        }
+        bool operator==(const iterator &other) const noexcept { return index_ == other.index_; }
+        bool operator!=(const iterator &other) const noexcept { return index_ != other.index_; }
+
+       private:
+        const CorpusView *view_;
+        uint32_t index_;
+    };
+
+    CorpusView() noexcept = default;
+
+    // Throws Error(parser_unexpected_value) if the image is not a well-formed corpus
+    explicit CorpusView(ByteSpan image) : image_(image) {
+        const uint8_t *p = image.data();
+        if (image.size() < CORPUS_HEADER_LEN || memcmp(p, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0 ||
+            detail::readLE(p + 8, 2) != CORPUS_VERSION) {
+            throw Error(parser_unexpected_value);
+        }
+        count_ = static_cast<uint32_t>(detail::readLE(p + 12, 4));
+        indexOffset_ = detail::readLE(p + 16, 8);
+        if (indexOffset_ > image.size() || (image.size() - indexOffset_) / CORPUS_ENTRY_LEN < count_) {
+            throw Error(parser_unexpected_value);
+        }
+        for (uint32_t i = 0; i < count_; i++) {
+            const uint8_t *e = p + indexOffset_ + size_t{i} * CORPUS_ENTRY_LEN;
+            const uint64_t offset = detail::readLE(e, 8);
+            const uint64_t len = detail::readLE(e + 8, 4) + detail::readLE(e + 12, 2);
+            if (offset > image.size() || image.size() - offset < len) {
+                throw Error(parser_unexpected_value);
+            }
+        }
+    }
+
+    uint32_t size() const noexcept { return count_; }
+    CorpusEntry operator[](uint32_t i) const noexcept {
+        return CorpusEntry(image_.data(), image_.data() + indexOffset_ + size_t{i} * CORPUS_ENTRY_LEN);
+    }
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator end() const noexcept { return iterator(this, count_); }
+
+   private:
+    ByteSpan image_;
+    uint32_t count_ = 0;
+    uint64_t indexOffset_ = 0;
+};
+
+// Read-only mapping of a corpus file
+class CorpusFile {
+   public:
+    // Throws Error(parser_unexpected_value) for unreadable or malformed files
+    explicit CorpusFile(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw Error(parser_unexpected_value);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            throw Error(parser_unexpected_value);
+        }
+        try {
+            view_ = CorpusView(ByteSpan(static_cast<const uint8_t *>(data_), size_));
+        } catch (...) {
+            munmap(data_, size_);
+            throw;
+        }
+    }
+
+    ~CorpusFile() {
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+    }
+
+    CorpusFile(const CorpusFile &) = delete;
+    CorpusFile &operator=(const CorpusFile &) = delete;
+
+    const CorpusView &view() const noexcept { return view_; }
+
+   private:
+    void *data_ = nullptr;
+    size_t size_ = 0;
+    CorpusView view_;
+};
+
+// Builds a corpus image in memory
+class CorpusWriter {
+   public:
+    void add(BlobType type, uint8_t flags, ByteSpan blob, std::string_view name, const OutputHash &outputHash,
+             const OutputHash &expertHash) {
+        Pending p;
+        p.type = type;
+        p.flags = flags;
+        p.blob.assign(blob.begin(), blob.end());
+        p.name = std::string(name.substr(0, UINT16_MAX));
+        p.outputHash = outputHash;
+        p.expertHash = expertHash;
+        entries_.push_back(std::move(p));
+    }
+
+    std::vector<uint8_t> finish() const {
+        const uint64_t indexOffset = CORPUS_HEADER_LEN;
+        const uint64_t dataOffset = indexOffset + entries_.size() * CORPUS_ENTRY_LEN;
+
+        std::vector<uint8_t> out(CORPUS_MAGIC, CORPUS_MAGIC + sizeof(CORPUS_MAGIC));
+        detail::writeLE(&out, CORPUS_VERSION, 2);
+        detail::writeLE(&out, 0, 2);
+        detail::writeLE(&out, entries_.size(), 4);
+        detail::writeLE(&out, indexOffset, 8);
+        detail::writeLE(&out, dataOffset, 8);
+
+        uint64_t offset = dataOffset;
+        for (const auto &e : entries_) {
+            detail::writeLE(&out, offset, 8);
+            detail::writeLE(&out, e.blob.size(), 4);
+            detail::writeLE(&out, e.name.size(), 2);
+            out.push_back(static_cast<uint8_t>(e.type));
+            out.push_back(e.flags);
+            out.insert(out.end(), e.outputHash.begin(), e.outputHash.end());
+            out.insert(out.end(), e.expertHash.begin(), e.expertHash.end());
+            offset += e.blob.size() + e.name.size();
+        }
+        for (const auto &e : entries_) {
+            out.insert(out.end(), e.blob.begin(), e.blob.end());
+            out.insert(out.end(), e.name.begin(), e.name.end());
+        }
+        return out;
+    }
+
+   private:
+    struct Pending {
+        BlobType type;
+        uint8_t flags;
+        std::vector<uint8_t> blob;
+        std::string name;
+        OutputHash outputHash;
+        OutputHash expertHash;
+    };
+
+    std::vector<Pending> entries_;
+};
+
+}  // namespace spacemesh
@@ -0,0 +1,358 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+// Structured export of a parsed transaction as JSON or CBOR (RFC 8949), straight from parser_tx_t.
+//
+// Amounts, nonces and vesting bounds are integers, addresses and keys are raw bytes (lowercase hex strings in
+// JSON). Nothing goes through bech32, fixed-point formatting or paging. The output is one map:
+//
+//   method        "spawn" | "spend" | "drain"
+//   version, genesis, principal, nonce, gas_price
+//   spend:        destination, amount
+//   drain:        vault, destination, amount
+//   spawn:        template, account_type ("wallet" | "multisig" | "vesting" | "vault") and
+//                 wallet:           pubkey
+//                 multisig/vesting: approvers, pubkeys (array)
+//                 vault:            owner, total_amount, initial_unlock_amount, vesting_start, vesting_end
+//
+// Like snprintf, the export functions write at most outLen bytes and return the length of the full encoding;
+// the output is complete only when the return value is <= outLen. exportJson does not NUL-terminate.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "parser_txdef.h"
+#include "spacemesh/tx.hpp"
+
+namespace spacemesh {
+
+enum class ExportFormat : uint8_t { Json, Cbor };
+
+namespace detail {
+
+class Sink {
+   public:
+    Sink(uint8_t *out, size_t cap) noexcept : out_(out), cap_(cap) {}
+
+    void put(uint8_t b) noexcept {
+        if (pos_ < cap_) {
+            out_[pos_] = b;
+        }
+        pos_++;
+    }
+    void put(const char *s) noexcept {
+        while (*s != 0) {
+            put(static_cast<uint8_t>(*s++));
+        }
+    }
+    size_t length() const noexcept { return pos_; }
+
+   private:
+    uint8_t *out_;
+    size_t cap_;
+    size_t pos_ = 0;
+};
+
+class CborWriter {
+   public:
+    explicit CborWriter(Sink *sink) noexcept : sink_(sink) {}
+
+    void beginMap(size_t n) noexcept { head(5, n); }
+    void endMap() noexcept {}
+    void beginArray(size_t n) noexcept { head(4, n); }
+    void endArray() noexcept {}
+    void key(const char *k) noexcept { text(k); }
+    void uint(uint64_t v) noexcept { head(0, v); }
+    void text(const char *s) noexcept {
+        head(3, strlen(s));
+        sink_->put(s);
+    }
+    void bytes(ByteSpan b) noexcept {
+        head(2, b.size());
+        for (const uint8_t c : b) {
+            sink_->put(c);
+        }
+    }
+
+   private:
+    // Shortest argument encoding, as required for deterministic CBOR
+    void head(uint8_t major, uint64_t v) noexcept {
+        const uint8_t mt = static_cast<uint8_t>(major << 5);
+        if (v < 24) {
+            sink_->put(static_cast<uint8_t>(mt | v));
+            return;
+        }
+        uint8_t len = 8;
+        uint8_t info = 27;
+        if (v <= UINT8_MAX) {
+            len = 1;
+            info = 24;
+        } else if (v <= UINT16_MAX) {
+            len = 2;
+            info = 25;
+        } else if (v <= UINT32_MAX) {
+            len = 4;
+            info = 26;
+        }
+        sink_->put(static_cast<uint8_t>(mt | info));
+        for (uint8_t i = len; i > 0; i--) {
+            sink_->put(static_cast<uint8_t>(v >> (8 * (i - 1))));
+        }
+    }
+
+    Sink *sink_;
+};
+
+class JsonWriter {
+   public:
+    explicit JsonWriter(Sink *sink) noexcept : sink_(sink) {}
+
+    void beginMap(size_t) noexcept {
+        value();
+        open('{');
+    }
+    void endMap() noexcept { close('}'); }
+    void beginArray(size_t) noexcept {
+        value();
+        open('[');
+    }
+    void endArray() noexcept { close(']'); }
+    void key(const char *k) noexcept {
+        separator();
+        quoted(k);
+        sink_->put(':');
+        afterKey_ = true;
+    }
+    void uint(uint64_t v) noexcept {
+        value();
+        char digits[20];
+        uint8_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+        while (n > 0) {
+            sink_->put(static_cast<uint8_t>(digits[--n]));
+        }
+    }
+    // Only used for the fixed ASCII names above, which need no escaping
+    void text(const char *s) noexcept {
+        value();
+        quoted(s);
+    }
+    void bytes(ByteSpan b) noexcept {
+        static const char hex[] = "0123456789abcdef";
+        value();
+        sink_->put('"');
+        for (const uint8_t c : b) {
+            sink_->put(static_cast<uint8_t>(hex[c >> 4]));
+            sink_->put(static_cast<uint8_t>(hex[c & 0x0F]));
+        }
+        sink_->put('"');
+    }
+
+   private:
+    static constexpr uint8_t MAX_DEPTH = 4;
+
+    void quoted(const char *s) noexcept {
+        sink_->put('"');
+        sink_->put(s);
+        sink_->put('"');
+    }
+    void separator() noexcept {
+        if (!first_[depth_]) {
+            sink_->put(',');
+        }
+        first_[depth_] = false;
+    }
+    // Values inside maps follow their key, array elements need a separator
+    void value() noexcept {
+        if (afterKey_) {
+            afterKey_ = false;
+        } else if (depth_ > 0) {
+            separator();
+        }
+    }
+    void open(char c) noexcept {
+        sink_->put(static_cast<uint8_t>(c));
+        depth_++;
+        first_[depth_] = true;
+    }
+    void close(char c) noexcept {
+        sink_->put(static_cast<uint8_t>(c));
+        depth_--;
+    }
+
+    Sink *sink_;
+    bool first_[MAX_DEPTH + 1] = {true};
+    uint8_t depth_ = 0;
+    bool afterKey_ = false;
+};
+
+inline const char *methodName(uint8_t selector) noexcept {
+    switch (selector) {
+        case METHOD_SPAWN:
+            return "spawn";
+        case METHOD_SPEND:
+            return "spend";
+        case METHOD_DRAIN_VAULT:
+            return "drain";
+        default:
+            return "unknown";
+    }
+}
+
+inline const char *accountTypeName(account_type_e type) noexcept {
+    switch (type) {
+        case WALLET:
+            return "wallet";
+        case MULTISIG:
+            return "multisig";
+        case VESTING:
+            return "vesting";
+        case VAULT:
+            return "vault";
+        default:
+            return "unknown";
+    }
+}
+
+// Map entries beyond the common header, CBOR maps are definite-length
+inline size_t bodyFields(const parser_tx_t &tx) noexcept {
+    switch (tx.methodSelector) {
+        case METHOD_SPEND:
+            return 2;
+        case METHOD_DRAIN_VAULT:
+            return 3;
+        case METHOD_SPAWN:
+            switch (tx.account_type) {
+                case WALLET:
+                    return 3;
+                case MULTISIG:
+                case VESTING:
+                    return 4;
+                case VAULT:
+                    return 7;
+                default:
+                    return 2;
+            }
+        default:
+            return 0;
+    }
+}
+
+template <typename Writer>
+void emitTx(const parser_tx_t &tx, Writer &w) noexcept {
+    constexpr size_t HEADER_FIELDS = 6;
+    w.beginMap(HEADER_FIELDS + bodyFields(tx));
+
+    w.key("method");
+    w.text(methodName(tx.methodSelector));
+    w.key("version");
+    w.uint(tx.tx_version);
+    w.key("genesis");
+    w.bytes(ByteSpan(tx_genesisId(&tx), GENESIS_LENGTH));
+    w.key("principal");
+    w.bytes(ByteSpan(tx_principal(&tx), ADDRESS_LENGTH));
+    w.key("nonce");
+    w.uint(tx.nonce);
+    w.key("gas_price");
+    w.uint(tx.gas_price);
+
+    switch (tx.methodSelector) {
+        case METHOD_SPEND:
+            w.key("destination");
+            w.bytes(ByteSpan(tx_spendDestination(&tx), ADDRESS_LENGTH));
+            w.key("amount");
+            w.uint(tx.spend.amount);
+            break;
+        case METHOD_DRAIN_VAULT:
+            w.key("vault");
+            w.bytes(ByteSpan(tx_drainVault(&tx), ADDRESS_LENGTH));
+            w.key("destination");
+            w.bytes(ByteSpan(tx_drainDestination(&tx), ADDRESS_LENGTH));
+            w.key("amount");
+            w.uint(tx.drain.amount);
+            break;
+        case METHOD_SPAWN:
+            w.key("template");
+            w.bytes(ByteSpan(tx_accountTemplate(&tx), ADDRESS_LENGTH));
+            w.key("account_type");
+            w.text(accountTypeName(tx.account_type));
+            switch (tx.account_type) {
+                case WALLET:
+                    w.key("pubkey");
+                    w.bytes(ByteSpan(tx_walletPubkey(&tx), PUB_KEY_LENGTH));
+                    break;
+                case MULTISIG:
+                case VESTING:
+                    w.key("approvers");
+                    w.uint(tx.spawn.multisig.approvers);
+                    w.key("pubkeys");
+                    w.beginArray(tx.spawn.multisig.numberOfPubkeys);
+                    for (uint8_t i = 0; i < tx.spawn.multisig.numberOfPubkeys; i++) {
+                        w.bytes(ByteSpan(tx_multisigPubkey(&tx, i), PUB_KEY_LENGTH));
+                    }
+                    w.endArray();
+                    break;
+                case VAULT:
+                    w.key("owner");
+                    w.bytes(ByteSpan(tx_vaultOwner(&tx), ADDRESS_LENGTH));
+                    w.key("total_amount");
+                    w.uint(tx.spawn.vault.totalAmount);
+                    w.key("initial_unlock_amount");
+                    w.uint(tx.spawn.vault.initialUnlockAmount);
+                    w.key("vesting_start");
+                    w.uint(tx.spawn.vault.vestingStart);
+                    w.key("vesting_end");
+                    w.uint(tx.spawn.vault.vestingEnd);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+
+    w.endMap();
+}
+
+}  // namespace detail
+
+inline size_t exportTx(const parser_tx_t &tx, ExportFormat format, uint8_t *out, size_t outLen) noexcept {
+    detail::Sink sink(out, outLen);
+    if (format == ExportFormat::Cbor) {
+        detail::CborWriter w(&sink);
+        detail::emitTx(tx, w);
+    } else {
+        detail::JsonWriter w(&sink);
+        detail::emitTx(tx, w);
+    }
+    return sink.length();
+}
+
+inline size_t exportJson(const ParsedTx &tx, char *out, size_t outLen) noexcept {
+    return exportTx(tx.raw(), ExportFormat::Json, reinterpret_cast<uint8_t *>(out), outLen);
+}
+
+inline size_t exportCbor(const ParsedTx &tx, uint8_t *out, size_t outLen) noexcept {
+    return exportTx(tx.raw(), ExportFormat::Cbor, out, outLen);
+}
+
+}  // namespace spacemesh
@@ -0,0 +1,348 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+// Header-only C++17 layer over app_lib for host services.
+//
+// ParsedTx borrows the caller's buffer: every ByteSpan it hands out points into that buffer, which must outlive
+// the ParsedTx. Parsing does not allocate. Display items are rendered on demand, one page at a time, into
+// buffers held by the returned Page.
+//
+// Rendering updates the ParsedTx's render cache and address memo, even through a const reference. A ParsedTx must
+// not be rendered from several threads at once; give each thread its own ParsedTx instead.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "parser.h"
+#include "parser_state.h"
+#include "parser_txdef.h"
+
+namespace spacemesh {
+
+// Non-owning view of bytes, in lieu of std::span
+class ByteSpan {
+   public:
+    constexpr ByteSpan() noexcept = default;
+    constexpr ByteSpan(const uint8_t *data, size_t size) noexcept : data_(data), size_(size) {}
+    constexpr ByteSpan(const Bytes_t &bytes) noexcept : data_(bytes.ptr), size_(bytes.len) {}
+
+    template <typename Container,
+              typename = std::enable_if_t<
+                  std::is_convertible_v<decltype(std::declval<const Container &>().data()), const uint8_t *>>>
+    constexpr ByteSpan(const Container &c) noexcept : data_(c.data()), size_(c.size()) {}
+
+    constexpr const uint8_t *data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr const uint8_t *begin() const noexcept { return data_; }
+    constexpr const uint8_t *end() const noexcept { return data_ + size_; }
+    constexpr uint8_t operator[](size_t i) const noexcept { return data_[i]; }
+
+   private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Thrown for any parser_error_t other than parser_ok; what() is the parser's static description
+class Error : public std::exception {
+   public:
+    explicit Error(parser_error_t code) noexcept : code_(code) {}
+
+    parser_error_t code() const noexcept { return code_; }
+    const char *what() const noexcept override { return parser_getErrorDescription(code_); }
+
+   private:
+    parser_error_t code_;
+};
+
+inline void check(parser_error_t err) {
+    if (err != parser_ok) {
+        throw Error(err);
+    }
+}
+
+enum class TxKind : uint8_t { Spawn = METHOD_SPAWN, Spend = METHOD_SPEND, Drain = METHOD_DRAIN_VAULT };
+
+enum class Network : uint8_t { Mainnet = NETWORK_MAINNET, Testnet = NETWORK_TESTNET };
+
+struct SpendView {
+    ByteSpan destination;
+    uint64_t amount;
+};
+
+struct DrainView {
+    ByteSpan vault;
+    ByteSpan destination;
+    uint64_t amount;
+};
+
+struct WalletSpawnView {
+    ByteSpan pubkey;
+};
+
+// Multisig and vesting spawns
+class MultisigSpawnView {
+   public:
+    explicit MultisigSpawnView(const parser_tx_t &tx) noexcept : tx_(&tx) {}
+
+    uint8_t approvers() const noexcept { return multisig().approvers; }
+    uint8_t participants() const noexcept { return multisig().numberOfPubkeys; }
+    ByteSpan pubkey(uint8_t i) const noexcept {
+        return i < participants() ? ByteSpan(tx_multisigPubkey(tx_, i), PUB_KEY_LENGTH) : ByteSpan();
+    }
+    // Hashed on each call, parsing does not compute it
+    std::array<uint8_t, KEYSET_DIGEST_LEN> keysetDigest() const {
+        std::array<uint8_t, KEYSET_DIGEST_LEN> digest{};
+        check(parser_keysetDigest(tx_, digest.data(), static_cast<uint16_t>(digest.size())));
+        return digest;
+    }
+
+   private:
+    const spawn_multisig_tx_t &multisig() const noexcept { return tx_->spawn.multisig; }
+
+    const parser_tx_t *tx_;
+};
+
+struct VaultSpawnView {
+    ByteSpan owner;
+    uint64_t totalAmount;
+    uint64_t initialUnlockAmount;
+    uint32_t vestingStart;
+    uint32_t vestingEnd;
+};
+
+struct SpawnView {
+    ByteSpan accountTemplate;
+    account_type_e accountType;
+};
+
+constexpr uint16_t PAGE_KEY_LEN = 40;
+constexpr uint16_t PAGE_VALUE_LEN = 128;
+// Characters per page when no width is given, as with the 39-byte buffers of the UI tests
+constexpr uint16_t DEFAULT_PAGE_WIDTH = 38;
+
+class Page {
+   public:
+    std::string_view key() const noexcept { return key_; }
+    std::string_view value() const noexcept { return value_; }
+    uint8_t index() const noexcept { return index_; }
+    uint8_t count() const noexcept { return count_; }
+
+   private:
+    friend class Item;
+    char key_[PAGE_KEY_LEN] = {0};
+    char value_[PAGE_VALUE_LEN] = {0};
+    uint8_t index_ = 0;
+    uint8_t count_ = 0;
+};
+
+// A display item, rendered when one of its pages is requested
+class Item {
+   public:
+    Item(const parser_context_t *ctx, uint8_t index, uint16_t width) noexcept : ctx_(ctx), index_(index), width_(width) {}
+
+    uint8_t index() const noexcept { return index_; }
+
+    Page page(uint8_t pageIdx) const {
+        Page p;
+        p.index_ = pageIdx;
+        check(parser_getItem(ctx_, index_, p.key_, sizeof(p.key_), p.value_, width_ + 1, pageIdx, &p.count_));
+        // The C API answers out-of-range pages with an empty value
+        if (pageIdx >= p.count_) {
+            throw Error(parser_display_page_out_of_range);
+        }
+        return p;
+    }
+
+    uint8_t pageCount() const { return page(0).count(); }
+
+    // Joins all pages; the only call here that allocates
+    std::string value() const {
+        std::string out;
+        Page p = page(0);
+        out.append(p.value());
+        for (uint8_t i = 1; i < p.count(); i++) {
+            out.append(page(i).value());
+        }
+        return out;
+    }
+
+   private:
+    const parser_context_t *ctx_;
+    uint8_t index_;
+    uint16_t width_;
+};
+
+class ItemRange {
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Item;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Item;
+
+        iterator(const parser_context_t *ctx, uint8_t index, uint16_t width) noexcept
+            : ctx_(ctx), index_(index), width_(width) {}
+
+        Item operator*() const noexcept { return Item(ctx_, index_, width_); }
+        iterator &operator++() noexcept {
+            index_++;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator prev = *this;
+            index_++;
+            return prev;
+        }
+        bool operator==(const iterator &other) const noexcept { return index_ == other.index_; }
+        bool operator!=(const iterator &other) const noexcept { return index_ != other.index_; }
+
+       private:
+        const parser_context_t *ctx_;
+        uint8_t index_;
+        uint16_t width_;
+    };
+
+    ItemRange(const parser_context_t *ctx, uint8_t count, uint16_t width) noexcept
+        : ctx_(ctx), count_(count), width_(width) {}
+
+    iterator begin() const noexcept { return iterator(ctx_, 0, width_); }
+    iterator end() const noexcept { return iterator(ctx_, count_, width_); }
+    uint8_t size() const noexcept { return count_; }
+    Item operator[](uint8_t index) const noexcept { return Item(ctx_, index, width_); }
+
+   private:
+    const parser_context_t *ctx_;
+    uint8_t count_;
+    uint16_t width_;
+};
+
+class ParsedTx {
+   public:
+    // displayFlags takes the DISPLAY_FLAG_* values of the sign APDU, network selects the hrp of rendered addresses
+    static ParsedTx parse(ByteSpan blob, uint8_t displayFlags = 0, Network network = Network::Mainnet) {
+        if (blob.size() > UINT16_MAX) {
+            throw Error(parser_value_out_of_range);
+        }
+        ParsedTx tx;
+        // Parsed for the expert review, the normal one is a prefix of it
+        check(parser_state_parseTx(&tx.state_, blob.data(), blob.size(), displayFlags,
+                                   static_cast<network_e>(network), true));
+        return tx;
+    }
+
+    ParsedTx(ParsedTx &&other) noexcept { *this = std::move(other); }
+    ParsedTx &operator=(ParsedTx &&other) noexcept {
+        if (this != &other) {
+            state_ = other.state_;
+            parser_state_relocate(&state_);
+            other.state_.ctx.tx_obj = nullptr;
+            other.state_.ctx.cache = nullptr;
+        }
+        return *this;
+    }
+    ParsedTx(const ParsedTx &) = delete;
+    ParsedTx &operator=(const ParsedTx &) = delete;
+
+    TxKind kind() const noexcept { return static_cast<TxKind>(tx().methodSelector); }
+    ByteSpan genesisId() const noexcept { return ByteSpan(tx_genesisId(&tx()), GENESIS_LENGTH); }
+    ByteSpan principal() const noexcept { return ByteSpan(tx_principal(&tx()), ADDRESS_LENGTH); }
+    uint64_t nonce() const noexcept { return tx().nonce; }
+    uint64_t gasPrice() const noexcept { return tx().gas_price; }
+
+    std::optional<SpendView> spend() const noexcept {
+        if (kind() != TxKind::Spend) {
+            return std::nullopt;
+        }
+        return SpendView{ByteSpan(tx_spendDestination(&tx()), ADDRESS_LENGTH), tx().spend.amount};
+    }
+
+    std::optional<DrainView> drain() const noexcept {
+        if (kind() != TxKind::Drain) {
+            return std::nullopt;
+        }
+        return DrainView{ByteSpan(tx_drainVault(&tx()), ADDRESS_LENGTH),
+                         ByteSpan(tx_drainDestination(&tx()), ADDRESS_LENGTH), tx().drain.amount};
+    }
+
+    std::optional<SpawnView> spawn() const noexcept {
+        if (kind() != TxKind::Spawn) {
+            return std::nullopt;
+        }
+        return SpawnView{ByteSpan(tx_accountTemplate(&tx()), ADDRESS_LENGTH), tx().account_type};
+    }
+
+    std::optional<WalletSpawnView> walletSpawn() const noexcept {
+        if (kind() != TxKind::Spawn || tx().account_type != WALLET) {
+            return std::nullopt;
+        }
+        return WalletSpawnView{ByteSpan(tx_walletPubkey(&tx()), PUB_KEY_LENGTH)};
+    }
+
+    std::optional<MultisigSpawnView> multisigSpawn() const noexcept {
+        if (kind() != TxKind::Spawn || (tx().account_type != MULTISIG && tx().account_type != VESTING)) {
+            return std::nullopt;
+        }
+        return MultisigSpawnView(tx());
+    }
+
+    std::optional<VaultSpawnView> vaultSpawn() const noexcept {
+        if (kind() != TxKind::Spawn || tx().account_type != VAULT) {
+            return std::nullopt;
+        }
+        const spawn_vault_tx_t &v = tx().spawn.vault;
+        return VaultSpawnView{ByteSpan(tx_vaultOwner(&tx()), ADDRESS_LENGTH), v.totalAmount, v.initialUnlockAmount,
+                              v.vestingStart, v.vestingEnd};
+    }
+
+    // Items of the normal review
+    ItemRange items(uint16_t pageWidth = DEFAULT_PAGE_WIDTH) const { return itemRange(false, pageWidth); }
+
+    // Items of the expert review. Its first items are those of items(), and share their rendering.
+    ItemRange expertItems(uint16_t pageWidth = DEFAULT_PAGE_WIDTH) const { return itemRange(true, pageWidth); }
+
+    const parser_tx_t &raw() const noexcept { return tx(); }
+    const parser_context_t &context() const noexcept { return state_.ctx; }
+
+   private:
+    ParsedTx() noexcept = default;
+
+    const parser_tx_t &tx() const noexcept { return state_.obj.tx; }
+
+    ItemRange itemRange(bool expert, uint16_t pageWidth) const {
+        if (pageWidth == 0 || pageWidth >= PAGE_VALUE_LEN) {
+            throw Error(parser_value_out_of_range);
+        }
+        uint8_t numItems = 0;
+        uint8_t numItemsExpert = 0;
+        check(parser_getNumItemsBothModes(&state_.ctx, &numItems, &numItemsExpert));
+        return ItemRange(&state_.ctx, expert ? numItemsExpert : numItems, pageWidth);
+    }
+
+    parser_state_t state_{};
+};
+
+}  // namespace spacemesh
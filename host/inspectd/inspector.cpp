@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "inspector.h"
+
+#include <sstream>
+
+#include "parser.h"
+#include "parser_message.h"
+#include "parser_state.h"
+
+namespace inspectd {
+namespace {
+// Same buffer sizes as the UI tests, so the lines match tests/testcases.json
+constexpr uint16_t KEY_LEN = 39;
+constexpr uint16_t VALUE_LEN = 39;
+
+using getNumItemsBothModes_t = parser_error_t (*)(const parser_context_t *, uint8_t *, uint8_t *);
+using getItem_t = parser_error_t (*)(const parser_context_t *, uint8_t, char *, uint16_t, char *, uint16_t, uint8_t,
+                                     uint8_t *);
+
+// Messages have a single review
+parser_error_t messageNumItemsBothModes(const parser_context_t *ctx, uint8_t *numItems, uint8_t *numItemsExpert) {
+    CHECK_ERROR(parser_message_getNumItems(ctx, numItems));
+    *numItemsExpert = *numItems;
+    return parser_ok;
+}
+
+parser_error_t renderItem(const parser_context_t *ctx, getItem_t getItem, uint8_t idx, std::vector<std::string> *lines) {
+    uint8_t pageCount = 1;
+    for (uint8_t pageIdx = 0; pageIdx < pageCount; pageIdx++) {
+        char key[KEY_LEN] = {0};
+        char value[VALUE_LEN] = {0};
+        CHECK_ERROR(getItem(ctx, idx, key, sizeof(key), value, sizeof(value), pageIdx, &pageCount));
+
+        std::stringstream ss;
+        ss << (int)idx << " | " << key;
+        if (pageCount > 1) {
+            ss << " [" << (int)pageIdx + 1 << "/" << (int)pageCount << "]";
+        }
+        ss << " : " << value;
+        lines->push_back(ss.str());
+    }
+    return parser_ok;
+}
+
+// ctx is set up for the expert review. Each item is rendered once, the normal lines are those of the first items.
+parser_error_t renderBothModes(const parser_context_t *ctx, getNumItemsBothModes_t getNumItemsBothModes,
+                               getItem_t getItem, Response *response) {
+    uint8_t numItems = 0;
+    uint8_t numItemsExpert = 0;
+    CHECK_ERROR(getNumItemsBothModes(ctx, &numItems, &numItemsExpert));
+
+    size_t normalLines = 0;
+    for (uint8_t idx = 0; idx < numItemsExpert; idx++) {
+        if (idx == numItems) {
+            normalLines = response->expertLines.size();
+        }
+        CHECK_ERROR(renderItem(ctx, getItem, idx, &response->expertLines));
+    }
+    if (numItems >= numItemsExpert) {
+        normalLines = response->expertLines.size();
+    }
+    response->lines.assign(response->expertLines.begin(), response->expertLines.begin() + normalLines);
+    return parser_ok;
+}
+}  // namespace
+
+Response inspect(const Request &request) {
+    Response response;
+    response.id = request.id;
+
+    // The parser context length is 16 bits wide
+    if (request.blob.size() > UINT16_MAX) {
+        response.status = parser_value_out_of_range;
+        return response;
+    }
+
+    const network_e network = (request.flags & FLAG_TESTNET) ? NETWORK_TESTNET : NETWORK_MAINNET;
+    parser_state_t state;
+
+    switch (request.type) {
+        case BlobType::Tx: {
+            const uint8_t displayFlags = (request.flags & FLAG_COMPACT) ? DISPLAY_FLAG_COMPACT : 0;
+            response.status =
+                parser_state_parseTx(&state, request.blob.data(), request.blob.size(), displayFlags, network, true);
+            if (response.status == parser_ok) {
+                response.status = renderBothModes(&state.ctx, parser_getNumItemsBothModes, parser_getItem, &response);
+            }
+            break;
+        }
+        case BlobType::Message: {
+            const uint8_t displayFlags = (request.flags & FLAG_MESSAGE_DIGEST) ? DISPLAY_FLAG_MESSAGE_DIGEST : 0;
+            response.status =
+                parser_state_parseMessage(&state, request.blob.data(), request.blob.size(), displayFlags, nullptr);
+            if (response.status == parser_ok) {
+                response.status =
+                    renderBothModes(&state.ctx, messageNumItemsBothModes, parser_message_getItem, &response);
+            }
+            break;
+        }
+        default:
+            response.status = parser_unexpected_type;
+            break;
+    }
+
+    if (response.status != parser_ok) {
+        response.lines.clear();
+        response.expertLines.clear();
+    }
+    return response;
+}
+
+}  // namespace inspectd
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "parser_common.h"
+
+namespace inspectd {
+
+enum class BlobType : uint8_t { Tx = 0, Message = 1 };
+
+// Request flags
+constexpr uint8_t FLAG_COMPACT = 0x01;         // DISPLAY_FLAG_COMPACT review, as P2 of the sign APDU
+constexpr uint8_t FLAG_TESTNET = 0x02;         // render stest addresses instead of sm
+constexpr uint8_t FLAG_MESSAGE_DIGEST = 0x04;  // DISPLAY_FLAG_MESSAGE_DIGEST review, as P2 of the sign message APDU
+
+struct Request {
+    uint32_t id = 0;
+    BlobType type = BlobType::Tx;
+    uint8_t flags = 0;
+    std::vector<uint8_t> blob;
+};
+
+struct Response {
+    uint32_t id = 0;
+    parser_error_t status = parser_ok;
+    // "idx | key [page/count] : value", one entry per display page, as in tests/testcases.json
+    std::vector<std::string> lines;
+    std::vector<std::string> expertLines;
+};
+
+// Parses and renders one blob in normal and expert mode. Safe to call from several threads.
+Response inspect(const Request &request);
+
+}  // namespace inspectd
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "server.h"
+
+// inspectd [--socket <path>] [--threads <n>]
+//
+// Serves the device display lines of tx and message blobs over a Unix domain socket, see protocol.h.
+
+namespace {
+constexpr const char *DEFAULT_SOCKET = "/tmp/spacemesh-inspectd.sock";
+
+void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--socket <path>] [--threads <n>]\n", argv0);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string socketPath = DEFAULT_SOCKET;
+    size_t threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // Signals are taken by a dedicated thread, every other thread inherits the blocked mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    inspectd::Server server(socketPath, threads);
+    if (!server.listen()) {
+        fprintf(stderr, "cannot listen on %s: %s\n", socketPath.c_str(), strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    std::thread signalThread([&server, signals] {
+        int sig = 0;
+        sigwait(&signals, &sig);
+        server.stop();
+    });
+
+    fprintf(stderr, "listening on %s with %zu threads\n", socketPath.c_str(), threads);
+    server.run();
+
+    // run() also returns on accept errors; wake the signal thread in case it is still waiting
+    kill(getpid(), SIGTERM);
+    signalThread.join();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "protocol.h"
+
+#include <string>
+
+#include "parser.h"
+
+namespace inspectd {
+namespace {
+void putU16(std::vector<uint8_t> *out, uint16_t v) {
+    out->push_back(static_cast<uint8_t>(v >> 8));
+    out->push_back(static_cast<uint8_t>(v));
+}
+
+void putU32(std::vector<uint8_t> *out, uint32_t v) {
+    putU16(out, static_cast<uint16_t>(v >> 16));
+    putU16(out, static_cast<uint16_t>(v));
+}
+
+void putStr(std::vector<uint8_t> *out, const std::string &s) {
+    const uint16_t len = s.size() > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(s.size());
+    putU16(out, len);
+    out->insert(out->end(), s.begin(), s.begin() + len);
+}
+
+void putLines(std::vector<uint8_t> *out, const std::vector<std::string> &lines) {
+    putU16(out, static_cast<uint16_t>(lines.size()));
+    for (const auto &line : lines) {
+        putStr(out, line);
+    }
+}
+
+// Prepends the frame length to a body written after a 4-byte placeholder
+std::vector<uint8_t> finishFrame(std::vector<uint8_t> frame) {
+    const uint32_t bodyLen = static_cast<uint32_t>(frame.size() - FRAME_LEN_SIZE);
+    frame[0] = static_cast<uint8_t>(bodyLen >> 24);
+    frame[1] = static_cast<uint8_t>(bodyLen >> 16);
+    frame[2] = static_cast<uint8_t>(bodyLen >> 8);
+    frame[3] = static_cast<uint8_t>(bodyLen);
+    return frame;
+}
+
+struct Reader {
+    const uint8_t *data;
+    size_t len;
+    size_t offset;
+
+    bool u16(uint16_t *v) {
+        if (len - offset < 2) {
+            return false;
+        }
+        *v = static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+        offset += 2;
+        return true;
+    }
+
+    bool str(std::string *s) {
+        uint16_t n = 0;
+        if (!u16(&n) || len - offset < n) {
+            return false;
+        }
+        s->assign(reinterpret_cast<const char *>(data + offset), n);
+        offset += n;
+        return true;
+    }
+
+    bool lines(std::vector<std::string> *out) {
+        uint16_t count = 0;
+        if (!u16(&count)) {
+            return false;
+        }
+        out->resize(count);
+        for (auto &line : *out) {
+            if (!str(&line)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+}  // namespace
+
+uint32_t readU32(const uint8_t *in) {
+    return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+           (static_cast<uint32_t>(in[2]) << 8) | in[3];
+}
+
+bool decodeRequest(const uint8_t *body, size_t bodyLen, Request *request) {
+    if (bodyLen < REQUEST_HEADER_LEN || bodyLen > MAX_REQUEST_LEN) {
+        return false;
+    }
+    request->id = readU32(body);
+    request->type = static_cast<BlobType>(body[4]);
+    request->flags = body[5];
+    request->blob.assign(body + REQUEST_HEADER_LEN, body + bodyLen);
+    return true;
+}
+
+bool decodeResponse(const uint8_t *body, size_t bodyLen, Response *response) {
+    if (bodyLen < 5) {
+        return false;
+    }
+    response->id = readU32(body);
+    response->status = static_cast<parser_error_t>(body[4]);
+    response->lines.clear();
+    response->expertLines.clear();
+
+    Reader r{body, bodyLen, 5};
+    if (response->status != parser_ok) {
+        std::string description;
+        return r.str(&description) && r.offset == bodyLen;
+    }
+    return r.lines(&response->lines) && r.lines(&response->expertLines) && r.offset == bodyLen;
+}
+
+std::vector<uint8_t> encodeRequest(const Request &request) {
+    std::vector<uint8_t> frame(FRAME_LEN_SIZE);
+    putU32(&frame, request.id);
+    frame.push_back(static_cast<uint8_t>(request.type));
+    frame.push_back(request.flags);
+    frame.insert(frame.end(), request.blob.begin(), request.blob.end());
+    return finishFrame(std::move(frame));
+}
+
+std::vector<uint8_t> encodeResponse(const Response &response) {
+    std::vector<uint8_t> frame(FRAME_LEN_SIZE);
+    putU32(&frame, response.id);
+    frame.push_back(static_cast<uint8_t>(response.status));
+    if (response.status != parser_ok) {
+        putStr(&frame, parser_getErrorDescription(response.status));
+    } else {
+        putLines(&frame, response.lines);
+        putLines(&frame, response.expertLines);
+    }
+    return finishFrame(std::move(frame));
+}
+
+}  // namespace inspectd
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+// Wire format, all integers big endian:
+//
+//   frame    := len:u32 body[len]
+//   request  := id:u32 type:u8 flags:u8 blob[len - 6]
+//   response := id:u32 status:u8 normal:lines expert:lines      (status == parser_ok)
+//             | id:u32 status:u8 description:str                (otherwise)
+//   lines    := count:u16 str[count]
+//   str      := len:u16 bytes[len]
+//
+// Requests may be pipelined. Responses carry the request id and can arrive in any order.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "inspector.h"
+
+namespace inspectd {
+
+constexpr size_t FRAME_LEN_SIZE = 4;
+constexpr size_t REQUEST_HEADER_LEN = 6;
+// Largest blob the parser context can address
+constexpr uint32_t MAX_REQUEST_LEN = REQUEST_HEADER_LEN + UINT16_MAX;
+
+uint32_t readU32(const uint8_t *in);
+
+// body excludes the frame length. Returns false on a malformed body.
+bool decodeRequest(const uint8_t *body, size_t bodyLen, Request *request);
+bool decodeResponse(const uint8_t *body, size_t bodyLen, Response *response);
+
+// Both return the whole frame, length prefix included
+std::vector<uint8_t> encodeRequest(const Request &request);
+std::vector<uint8_t> encodeResponse(const Response &response);
+
+}  // namespace inspectd
@@ -0,0 +1,199 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "server.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+
+#include "inspector.h"
+#include "protocol.h"
+
+namespace inspectd {
+
+struct Connection {
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { close(fd); }
+
+    const int fd;
+
+    // Workers finish in any order, frames must not interleave
+    std::mutex writeMutex;
+
+    std::mutex pendingMutex;
+    std::condition_variable pendingCv;
+    size_t pending = 0;
+};
+
+namespace {
+bool readExact(int fd, uint8_t *out, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        const ssize_t n = recv(fd, out + done, len - done, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const uint8_t *data, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        const ssize_t n = send(fd, data + done, len - done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+}  // namespace
+
+Server::Server(std::string socketPath, size_t threads) : socketPath_(std::move(socketPath)), pool_(threads) {}
+
+Server::~Server() { stop(); }
+
+bool Server::listen() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    memcpy(addr.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    unlink(socketPath_.c_str());
+    if (bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return false;
+    }
+    listenFd_ = fd;
+    return true;
+}
+
+void Server::run() {
+    while (!stopping_) {
+        const int fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+
+        auto connection = std::make_shared<Connection>(fd);
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        if (stopping_) {
+            break;
+        }
+        connections_.push_back(connection);
+        activeReaders_++;
+        std::thread([this, connection] { serve(connection); }).detach();
+    }
+}
+
+void Server::stop() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+
+    const int fd = listenFd_.exchange(-1);
+    if (fd >= 0) {
+        // Wakes up accept()
+        shutdown(fd, SHUT_RDWR);
+        close(fd);
+        unlink(socketPath_.c_str());
+    }
+
+    std::unique_lock<std::mutex> lock(connectionsMutex_);
+    for (const auto &connection : connections_) {
+        shutdown(connection->fd, SHUT_RDWR);
+    }
+    readersDone_.wait(lock, [this] { return activeReaders_ == 0; });
+}
+
+void Server::serve(std::shared_ptr<Connection> connection) {
+    std::vector<uint8_t> body;
+
+    while (!stopping_) {
+        uint8_t lenBytes[FRAME_LEN_SIZE];
+        if (!readExact(connection->fd, lenBytes, sizeof(lenBytes))) {
+            break;
+        }
+        const uint32_t bodyLen = readU32(lenBytes);
+        if (bodyLen > MAX_REQUEST_LEN) {
+            break;
+        }
+        body.resize(bodyLen);
+        if (!readExact(connection->fd, body.data(), body.size())) {
+            break;
+        }
+
+        Request request;
+        if (!decodeRequest(body.data(), body.size(), &request)) {
+            break;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(connection->pendingMutex);
+            connection->pendingCv.wait(lock, [&] { return connection->pending < MAX_PENDING_PER_CONNECTION; });
+            connection->pending++;
+        }
+
+        pool_.submit([connection, request = std::move(request)] {
+            const std::vector<uint8_t> frame = encodeResponse(inspect(request));
+            {
+                std::lock_guard<std::mutex> lock(connection->writeMutex);
+                writeAll(connection->fd, frame.data(), frame.size());
+            }
+            {
+                std::lock_guard<std::mutex> lock(connection->pendingMutex);
+                connection->pending--;
+            }
+            connection->pendingCv.notify_one();
+        });
+    }
+
+    // Workers still holding this connection write their responses, the fd closes with the last reference
+    shutdown(connection->fd, SHUT_RD);
+
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    connections_.erase(std::find(connections_.begin(), connections_.end(), connection));
+    activeReaders_--;
+    readersDone_.notify_all();
+}
+
+}  // namespace inspectd
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace inspectd {
+
+// Requests a single connection may have queued or in flight before its reader stops reading
+constexpr size_t MAX_PENDING_PER_CONNECTION = 64;
+
+struct Connection;
+
+// Accepts connections on a Unix domain socket. Each connection has a reader thread that decodes frames and hands
+// them to the shared worker pool; workers write responses back as soon as they are ready.
+class Server {
+   public:
+    Server(std::string socketPath, size_t threads);
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    // Binds and listens, replacing a stale socket file. Returns false and leaves errno set on failure.
+    bool listen();
+
+    // Accept loop, returns after stop()
+    void run();
+
+    // Stops accepting, closes the connections and waits for their readers. Safe to call from any thread.
+    void stop();
+
+   private:
+    void serve(std::shared_ptr<Connection> connection);
+
+    std::string socketPath_;
+    std::atomic<int> listenFd_{-1};
+    std::atomic<bool> stopping_{false};
+    ThreadPool pool_;
+
+    // Readers are detached; stop() waits on readersDone_ until all of them have left serve()
+    std::mutex connectionsMutex_;
+    std::condition_variable readersDone_;
+    std::vector<std::shared_ptr<Connection>> connections_;
+    size_t activeReaders_ = 0;
+};
+
+}  // namespace inspectd
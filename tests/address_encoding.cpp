@@ -128,7 +128,9 @@ TEST(Keys, VaultAddressEncoding) {
         const string prefix = "stest";
         const bool isTestNet = testcase.address.substr(0, prefix.size()) == prefix;
         pubkey_item_t internalPubkey{};
+        generic_account_t owner{};
         vault_account_t vaultAccount{};
+        vaultAccount.owner = &owner;
 
         // Read pubkeys from testvectors and set up owner account in vault account
         internalPubkey.index = 0;
@@ -137,12 +139,12 @@ TEST(Keys, VaultAddressEncoding) {
             if (i == internalPubkey.index) {
                 parseHexString(internalPubkey.pubkey, PUB_KEY_LENGTH, testcase.owner.publicKeys[i].c_str());
             } else {
-                parseHexString(vaultAccount.owner.keys[indexAux].pubkey, 32, testcase.owner.publicKeys[i].c_str());
+                parseHexString(owner.keys[indexAux].pubkey, 32, testcase.owner.publicKeys[i].c_str());
                 indexAux++;
             }
         }
-        vaultAccount.owner.participants = testcase.owner.participants;
-        vaultAccount.owner.approvers = testcase.owner.approvals;
+        owner.participants = testcase.owner.participants;
+        owner.approvers = testcase.owner.approvals;
 
         // set up vault account
         vaultAccount.totalAmount = testcase.totalAmount;
@@ -161,3 +163,88 @@ TEST(Keys, VaultAddressEncoding) {
         EXPECT_EQ(str, testcase.address);
     }
 }
+
+namespace {
+// internal index, approvers, participants, [vault terms], external keys sorted by index
+vector<uint8_t> buildAddressRequest(uint8_t internalIndex, uint8_t approvers, uint8_t participants, bool vault) {
+    vector<uint8_t> request = {internalIndex};
+    if (vault) {
+        request.insert(request.end(), 24, 0x11);
+    }
+    request.push_back(approvers);
+    request.push_back(participants);
+    for (uint8_t i = 0; i < participants; i++) {
+        if (i == internalIndex) {
+            continue;
+        }
+        request.push_back(i);
+        request.insert(request.end(), PUB_KEY_LENGTH, static_cast<uint8_t>(0xA0 + i));
+    }
+    return request;
+}
+
+zxerr_t parseRequest(const vector<uint8_t> &request, account_type_e type, address_request_t *out) {
+    return parseAddressRequest(request.data(), static_cast<uint16_t>(request.size()), type, out);
+}
+}  // namespace
+
+TEST(AddressRequest, FullMultisigAndVault) {
+    address_request_t request{};
+
+    // 10 participants: 9 external keys do not fit a byte-sized length
+    auto multisig = buildAddressRequest(4, 3, MAX_MULTISIG_PUB_KEY, false);
+    ASSERT_EQ(parseRequest(multisig, MULTISIG, &request), zxerr_ok);
+    EXPECT_EQ(request.account_type, MULTISIG);
+    EXPECT_EQ(request.internalIndex, 4);
+    EXPECT_EQ(request.optional_numberOfPubkeys, MAX_MULTISIG_PUB_KEY - 1);
+    EXPECT_EQ(request.account->participants, MAX_MULTISIG_PUB_KEY);
+    EXPECT_EQ(request.account->keys[8].index, 9);
+
+    // Little-endian terms right after the internal index, so none of them is aligned in the buffer
+    auto vault = buildAddressRequest(0, 1, 2, true);
+    const uint8_t terms[24] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xF0, 0x00, 0x00, 0x00,
+                               0x00, 0x00, 0x00, 0x80, 0x20, 0x03, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF};
+    copy(begin(terms), end(terms), vault.begin() + 1);
+    ASSERT_EQ(parseRequest(vault, VAULT, &request), zxerr_ok);
+    EXPECT_EQ(request.vault_account.totalAmount, 0x0807060504030201ULL);
+    EXPECT_EQ(request.vault_account.initialUnlockAmount, 0x80000000000000F0ULL);
+    EXPECT_EQ(request.vault_account.vestingStart, 800u);
+    EXPECT_EQ(request.vault_account.vestingEnd, UINT32_MAX);
+    EXPECT_EQ(request.account_type, VAULT);
+    EXPECT_EQ(request.optional_numberOfPubkeys, 1);
+    EXPECT_EQ(request.vault_account.owner, request.account);
+    EXPECT_EQ(request.account->keys[0].index, 1);
+}
+
+TEST(AddressRequest, MalformedRequests) {
+    address_request_t request{};
+
+    // Shorter than the header
+    EXPECT_EQ(parseRequest({0x00, 0x01}, MULTISIG, &request), zxerr_invalid_crypto_settings);
+    EXPECT_EQ(parseRequest(buildAddressRequest(0, 1, 1, false), VAULT, &request), zxerr_invalid_crypto_settings);
+
+    // Internal index outside of the participants
+    auto request1 = buildAddressRequest(0, 1, 3, false);
+    request1[0] = 3;
+    EXPECT_EQ(parseRequest(request1, MULTISIG, &request), zxerr_invalid_crypto_settings);
+
+    // No approvers, or more approvers than participants
+    EXPECT_EQ(parseRequest(buildAddressRequest(0, 0, 3, false), MULTISIG, &request), zxerr_invalid_crypto_settings);
+    EXPECT_EQ(parseRequest(buildAddressRequest(0, 4, 3, true), VAULT, &request), zxerr_invalid_crypto_settings);
+
+    // More participants than supported
+    auto request2 = buildAddressRequest(0, 1, MAX_MULTISIG_PUB_KEY + 1, false);
+    EXPECT_EQ(parseRequest(request2, VESTING, &request), zxerr_invalid_crypto_settings);
+
+    // Keys out of order
+    auto request3 = buildAddressRequest(0, 1, 3, false);
+    std::swap(request3[3], request3[3 + 1 + PUB_KEY_LENGTH]);
+    EXPECT_EQ(parseRequest(request3, MULTISIG, &request), zxerr_invalid_crypto_settings);
+
+    // Partial pubkey
+    auto request4 = buildAddressRequest(0, 1, 2, false);
+    request4.pop_back();
+    EXPECT_EQ(parseRequest(request4, MULTISIG, &request), zxerr_invalid_crypto_settings);
+
+    EXPECT_EQ(parseRequest(buildAddressRequest(0, 1, 2, false), WALLET, &request), zxerr_encoding_failed);
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "addrgen.h"
+#include "gmock/gmock.h"
+
+using namespace std;
+
+namespace {
+const string KEY_A = "97f3bd871315281e8b83edc7a9fd0541066154449070ccdb3cdd42cf69ccde88";
+const string KEY_B = "6f1581709bb7b1ef030d210db18e3b0ba1c776fba65d8cdaad05415142d189f8";
+const string KEY_C = "8ed90420802c83b41e4a7fa94ce5f05792ea8bff3d7a63572e5c73454eaef51d";
+const string KEY_W = "7845b5138380435769c4567bf3dc4a50e7439b2ccd6f47abe0b7b9cf1b1a9fd7";
+
+// Same vectors as address_encoding.h
+const vector<pair<string, string>> CSV_VECTORS = {
+    {"wallet,mainnet,," + KEY_W, "sm1qqqqqq9sfndatlp8h02klu34j085n0heel8efsga7gp78"},
+    {"wallet,testnet,," + KEY_W, "stest1qqqqqq9sfndatlp8h02klu34j085n0heel8efsgqt3es7"},
+    {"multisig,mainnet,1," + KEY_A, "sm1qqqqqq9k88d0v36rm56nk53u3a0xrg8nuljzn7qnlld5m"},
+    {"multisig,mainnet,1," + KEY_A + ";" + KEY_B, "sm1qqqqqq9r9ac5g4np2umtx3u47qjfhg4jzh9ydkc82uw0a"},
+    {"vesting,mainnet,2," + KEY_A + ";" + KEY_B, "sm1qqqqqq990g4t9t7gqskhllfsln2jsqcal689zeqlaqqs0"},
+    {"vault,mainnet,1," + KEY_A + ",10,987,0,44", "sm1qqqqqqx8mjlnar0nj29h2tm8yzujpzswtd2whcca03zzh"},
+    {"vault,mainnet,2," + KEY_A + ";" + KEY_B + ",10,987,0,44", "sm1qqqqqqxs7hvfy5880nccgjmz9w2wlgqmy0yttxs2haxct"},
+    {"vault,mainnet,3," + KEY_A + ";" + KEY_B + ";" + KEY_C + ",10,987,0,44",
+     "sm1qqqqqq8u7cumpw5usq2k9fkvlzadpjev4kw5deg209my6"},
+};
+
+string process(const string &line, addrgen::Format format) {
+    bool ok = false;
+    const string out = addrgen::processLine(line, format, &ok);
+    EXPECT_TRUE(ok) << line << " -> " << out;
+    return out;
+}
+}  // namespace
+
+TEST(Addrgen, CsvMatchesAddressVectors) {
+    for (const auto &v : CSV_VECTORS) {
+        EXPECT_EQ(process(v.first, addrgen::Format::Csv), v.second);
+    }
+}
+
+TEST(Addrgen, JsonlMatchesCsv) {
+    const string vault = R"({"type":"vault","network":"mainnet","approvers":2,"pubkeys":[")" + KEY_A + R"(",")" +
+                         KEY_B +
+                         R"("],"total_amount":10,"initial_unlock_amount":987,"vesting_start":0,"vesting_end":44})";
+    EXPECT_EQ(process(vault, addrgen::Format::Jsonl), R"({"address":")" + CSV_VECTORS[6].second + R"("})");
+
+    const string wallet = R"({"type":"wallet","network":"testnet","pubkeys":[")" + KEY_W + R"("]})";
+    EXPECT_EQ(process(wallet, addrgen::Format::Jsonl), R"({"address":")" + CSV_VECTORS[1].second + R"("})");
+}
+
+TEST(Addrgen, RejectsInvalidSpecs) {
+    const vector<string> invalid = {
+        "wallet,mainnet,",
+        "account,mainnet,1," + KEY_A,
+        "multisig,devnet,1," + KEY_A,
+        "multisig,mainnet,0," + KEY_A,
+        "multisig,mainnet,2," + KEY_A,
+        "wallet,mainnet,," + KEY_A + ";" + KEY_B,
+        "wallet,mainnet,," + KEY_A.substr(1),
+        "wallet,mainnet,," + KEY_A.substr(2) + "zz",
+        "vault,mainnet,1," + KEY_A,
+        "vault,mainnet,1," + KEY_A + ",10,987,0,4294967296",
+        "multisig,mainnet,1," + KEY_A + ",10,987,0,44",
+    };
+    for (const auto &line : invalid) {
+        bool ok = true;
+        EXPECT_THAT(addrgen::processLine(line, addrgen::Format::Csv, &ok), testing::StartsWith("error: ")) << line;
+        EXPECT_FALSE(ok) << line;
+    }
+
+    bool ok = true;
+    EXPECT_THAT(addrgen::processLine("{\"type\":", addrgen::Format::Jsonl, &ok), testing::StartsWith("{\"error\":"));
+    EXPECT_FALSE(ok);
+}
+
+TEST(Addrgen, RunKeepsInputOrderAcrossThreads) {
+    // Enough lines for several batches per thread, with an error and skipped lines in between
+    stringstream in;
+    vector<string> expected;
+    for (size_t i = 0; i < 20000; i++) {
+        if (i % 1000 == 0) {
+            in << "# comment\n\n";
+        }
+        if (i == 12345) {
+            in << "wallet,mainnet,,00\n";
+            expected.push_back("error: invalid pubkey");
+            continue;
+        }
+        const auto &v = CSV_VECTORS[i % CSV_VECTORS.size()];
+        in << v.first << "\n";
+        expected.push_back(v.second);
+    }
+
+    stringstream out;
+    const addrgen::RunStats stats = addrgen::run(in, out, addrgen::Format::Csv, 3);
+    EXPECT_EQ(stats.accounts, expected.size());
+    EXPECT_EQ(stats.errors, 1u);
+
+    vector<string> lines;
+    string line;
+    while (getline(out, line)) {
+        lines.push_back(line);
+    }
+    EXPECT_EQ(lines, expected);
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "parser_impl.h"
+#include "scale_helper.h"
+
+using namespace std;
+
+namespace {
+parser_error_t readU64(const vector<uint8_t> &encoded, uint64_t *value) {
+    parser_context_t ctx = {};
+    ctx.buffer = encoded.data();
+    ctx.bufferLen = static_cast<uint16_t>(encoded.size());
+    return readCompactU64(&ctx, value);
+}
+}  // namespace
+
+TEST(CompactInt, CanonicalBoundaries) {
+    const struct {
+        vector<uint8_t> encoded;
+        uint64_t value;
+    } valid[] = {
+        {{0x00}, 0},
+        {{0xfc}, 63},
+        {{0x01, 0x01}, 64},
+        {{0xfd, 0xff}, 16383},
+        {{0x02, 0x00, 0x01, 0x00}, 16384},
+        {{0xfe, 0xff, 0xff, 0xff}, (1ULL << 30) - 1},
+        {{0x03, 0x00, 0x00, 0x00, 0x40}, 1ULL << 30},
+        {{0x07, 0x00, 0x00, 0x00, 0x00, 0x01}, 1ULL << 32},
+        {{0x13, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3f}, (1ULL << 62) - 1},
+    };
+
+    for (const auto &tc : valid) {
+        uint64_t value = 0;
+        EXPECT_EQ(readU64(tc.encoded, &value), parser_ok) << tc.value;
+        EXPECT_EQ(value, tc.value);
+    }
+}
+
+TEST(CompactInt, NonCanonicalRejected) {
+    const vector<vector<uint8_t>> invalid = {
+        // 63 in 2-byte mode
+        {0xfd, 0x00},
+        // 16383 in 4-byte mode
+        {0xfe, 0xff, 0x00, 0x00},
+        // 2^30 - 1 in bigint mode
+        {0x03, 0xff, 0xff, 0xff, 0x3f},
+        // 2^30 with a zero-padded 5-byte length
+        {0x07, 0x00, 0x00, 0x00, 0x40, 0x00},
+        // Above 2^62 - 1
+        {0x13, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40},
+    };
+
+    for (const auto &encoded : invalid) {
+        uint64_t value = 0;
+        EXPECT_EQ(readU64(encoded, &value), parser_value_out_of_range);
+    }
+}
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "parser.h"
+#include "parser_message.h"
+#include "spacemesh/corpus.hpp"
+#include "utils/common.h"
+
+using namespace std;
+
+namespace {
+bool sameHash(const spacemesh::OutputHash &actual, spacemesh::ByteSpan expected) {
+    return equal(actual.begin(), actual.end(), expected.begin(), expected.end());
+}
+
+vector<string> render(const spacemesh::CorpusEntry &entry, bool expert) {
+    parser_context_t ctx;
+    if (entry.type() == spacemesh::BlobType::Message) {
+        parser_message_tx_t msgObj;
+        const uint8_t displayFlags = entry.messageDigest() ? DISPLAY_FLAG_MESSAGE_DIGEST : 0;
+        EXPECT_EQ(parser_message_parse_streamed(&ctx, entry.blob().data(), entry.blob().size(), &msgObj, displayFlags,
+                                                nullptr),
+                  parser_ok);
+        return dumpRawUI(&ctx, 39, 39);
+    }
+
+    parser_tx_t txObj;
+    EXPECT_EQ(parser_parse(&ctx, entry.blob().data(), entry.blob().size(), &txObj), parser_ok);
+    ctx.displayFlags = entry.compact() ? DISPLAY_FLAG_COMPACT : 0;
+    ctx.network = entry.mainnet() ? NETWORK_MAINNET : NETWORK_TESTNET;
+    ctx.expert = expert;
+    parser_display_cache_t cache;
+    parser_attach_cache(&ctx, &cache);
+    return dumpUI(&ctx, 39, 39);
+}
+
+vector<uint8_t> sampleImage() {
+    const vector<uint8_t> blob = {0x01, 0x02, 0x03};
+    spacemesh::CorpusWriter writer;
+    writer.add(spacemesh::BlobType::Tx, spacemesh::CORPUS_FLAG_MAINNET, blob, "first", spacemesh::hashOutput({"a"}),
+               spacemesh::hashOutput({"b"}));
+    writer.add(spacemesh::BlobType::Message, 0, spacemesh::ByteSpan(), "second", spacemesh::hashOutput({}),
+               spacemesh::hashOutput({}));
+    return writer.finish();
+}
+}  // namespace
+
+TEST(Corpus, MatchesTestVectors) {
+    const spacemesh::CorpusFile file(TESTVECTORS_CORPUS);
+    ASSERT_GT(file.view().size(), 0u);
+
+    for (const auto entry : file.view()) {
+        const string name(entry.name());
+
+        EXPECT_TRUE(sameHash(spacemesh::hashOutput(render(entry, false)), entry.outputHash())) << name;
+
+        // Message vectors are only reviewed in normal mode
+        if (entry.type() == spacemesh::BlobType::Tx) {
+            EXPECT_TRUE(sameHash(spacemesh::hashOutput(render(entry, true)), entry.expertHash())) << name;
+        }
+    }
+}
+
+TEST(Corpus, WriterRoundTrip) {
+    const vector<uint8_t> image = sampleImage();
+    const spacemesh::CorpusView view(image);
+    ASSERT_EQ(view.size(), 2u);
+
+    EXPECT_EQ(view[0].name(), "first");
+    EXPECT_EQ(view[0].type(), spacemesh::BlobType::Tx);
+    EXPECT_TRUE(view[0].mainnet());
+    EXPECT_FALSE(view[0].compact());
+    EXPECT_THAT(vector<uint8_t>(view[0].blob().begin(), view[0].blob().end()), testing::ElementsAre(1, 2, 3));
+    EXPECT_TRUE(sameHash(spacemesh::hashOutput({"a"}), view[0].outputHash()));
+    EXPECT_TRUE(sameHash(spacemesh::hashOutput({"b"}), view[0].expertHash()));
+
+    EXPECT_EQ(view[1].name(), "second");
+    EXPECT_EQ(view[1].type(), spacemesh::BlobType::Message);
+    EXPECT_EQ(view[1].blob().size(), 0u);
+
+    // Blobs are views into the image, not copies
+    EXPECT_GE(view[0].blob().data(), image.data());
+    EXPECT_LT(view[0].blob().data(), image.data() + image.size());
+}
+
+TEST(Corpus, RejectsMalformedImages) {
+    const vector<uint8_t> image = sampleImage();
+    auto rejects = [](const vector<uint8_t> &bad) {
+        try {
+            spacemesh::CorpusView view(bad);
+        } catch (const spacemesh::Error &e) {
+            return e.code() == parser_unexpected_value;
+        }
+        return false;
+    };
+
+    // Truncated anywhere, including inside the data area
+    for (size_t len = 0; len < image.size(); len++) {
+        EXPECT_TRUE(rejects(vector<uint8_t>(image.begin(), image.begin() + len))) << len;
+    }
+
+    vector<uint8_t> bad = image;
+    bad[0] = 'X';
+    EXPECT_TRUE(rejects(bad));
+
+    bad = image;
+    bad[8] = spacemesh::CORPUS_VERSION + 1;
+    EXPECT_TRUE(rejects(bad));
+
+    // Entry count larger than the index
+    bad = image;
+    bad[12] = 0xFF;
+    EXPECT_TRUE(rejects(bad));
+
+    // Entry offset past the end of the image
+    bad = image;
+    bad[spacemesh::CORPUS_HEADER_LEN + 7] = 0x80;
+    EXPECT_TRUE(rejects(bad));
+}
+
+TEST(Corpus, OutputHashIsBounded) {
+    // Exactly at the limit, the last line's newline included
+    vector<string> lines = {string(spacemesh::OUTPUT_HASH_MAX_INPUT_LEN - 1, 'x')};
+    EXPECT_NO_THROW(spacemesh::hashOutput(lines));
+
+    lines.emplace_back("");
+    try {
+        (void)spacemesh::hashOutput(lines);
+        FAIL() << "expected spacemesh::Error";
+    } catch (const spacemesh::Error &e) {
+        EXPECT_EQ(e.code(), parser_value_out_of_range);
+    }
+}
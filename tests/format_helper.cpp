@@ -0,0 +1,157 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "format_helper.h"
+
+#include <zxformat.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+using namespace std;
+
+namespace {
+// Previous printNumber formatting chain, used as reference
+string referenceFixedPoint(uint64_t amount, uint8_t decimalPlaces, const char *prefix, const char *postfix) {
+    char bufferUI[200] = {0};
+    EXPECT_EQ(uint64_to_str(bufferUI, sizeof(bufferUI), amount), nullptr);
+    EXPECT_NE(intstr_to_fpstr_inplace(bufferUI, sizeof(bufferUI), decimalPlaces), 0u);
+    EXPECT_EQ(z_str3join(bufferUI, sizeof(bufferUI), prefix, postfix), zxerr_ok);
+    number_inplace_trimming(bufferUI, 1);
+    return string(bufferUI);
+}
+
+vector<uint64_t> boundaryValues() {
+    vector<uint64_t> values = {0, 1, 2, 9, 10, 99, 100, UINT64_MAX, UINT64_MAX - 1, UINT64_MAX / 2};
+    uint64_t power = 1;
+    for (int i = 0; i < 20; i++) {
+        values.push_back(power);
+        values.push_back(power - 1);
+        values.push_back(power + 1);
+        values.push_back(power * 3);
+        if (i < 19) {
+            power *= 10;
+        }
+    }
+    return values;
+}
+
+void checkValue(uint64_t amount) {
+    // Same argument combinations used by the parser
+    const struct {
+        uint8_t decimals;
+        const char *prefix;
+    } modes[] = {{9, "SMH "}, {0, "SMIDGE "}, {0, ""}, {9, ""}};
+
+    for (const auto &mode : modes) {
+        char out[FIXED_POINT_BUFFER_LEN] = {0};
+        ASSERT_EQ(formatFixedPoint(out, sizeof(out), amount, mode.decimals, mode.prefix, ""), parser_ok);
+        EXPECT_EQ(string(out), referenceFixedPoint(amount, mode.decimals, mode.prefix, ""))
+            << "amount " << amount << " decimals " << (int)mode.decimals;
+    }
+}
+}  // namespace
+
+TEST(FormatHelper, FixedPointBoundaries) {
+    for (const auto value : boundaryValues()) {
+        checkValue(value);
+    }
+}
+
+TEST(FormatHelper, FixedPointRandom) {
+    mt19937_64 rng(0x5350414345u);
+    for (int i = 0; i < 100000; i++) {
+        // Spread the values over every digit count
+        const uint64_t value = rng() >> (rng() % 64);
+        checkValue(value);
+    }
+}
+
+TEST(FormatHelper, FixedPointSmallBuffer) {
+    char out[8] = {0};
+    EXPECT_EQ(formatFixedPoint(out, sizeof(out), 1000000000, 9, "SMH ", ""), parser_ok);
+    EXPECT_EQ(string(out), "SMH 1.0");
+    EXPECT_EQ(formatFixedPoint(out, sizeof(out), 10000000000, 9, "SMH ", ""), parser_unexpected_buffer_end);
+}
+
+TEST(FormatHelper, HexPagingMatchesPageStringHex) {
+    mt19937_64 rng(0x484558u);
+    uint8_t data[64];
+    for (auto &b : data) {
+        b = static_cast<uint8_t>(rng());
+    }
+
+    // pageStringHex only slices cleanly on even page widths
+    for (const uint16_t inLen : {1, 20, 32, 33, 64}) {
+        for (uint16_t outLen = 3; outLen <= 130; outLen += 2) {
+            uint8_t refPageCount = 0;
+            char ref[130] = {0};
+            pageStringHex(ref, outLen, reinterpret_cast<const char *>(data), inLen, 0, &refPageCount);
+
+            for (uint8_t pageIdx = 0; pageIdx <= refPageCount; pageIdx++) {
+                uint8_t pageCount = 0;
+                char out[130] = {0};
+                pageStringHex(ref, outLen, reinterpret_cast<const char *>(data), inLen, pageIdx, &refPageCount);
+                pageHexString(out, outLen, data, inLen, false, 0, pageIdx, &pageCount);
+                EXPECT_EQ(pageCount, refPageCount);
+                EXPECT_EQ(string(out), string(ref)) << "inLen " << inLen << " outLen " << outLen << " page " << (int)pageIdx;
+            }
+        }
+    }
+}
+
+TEST(FormatHelper, HexUppercaseAndGrouping) {
+    const uint8_t data[] = {0xde, 0xad, 0xbe, 0xef, 0x01};
+    char out[32] = {0};
+    uint8_t pageCount = 0;
+
+    pageHexString(out, sizeof(out), data, sizeof(data), true, 0, 0, &pageCount);
+    EXPECT_EQ(string(out), "DEADBEEF01");
+    EXPECT_EQ(pageCount, 1);
+
+    pageHexString(out, sizeof(out), data, sizeof(data), false, 4, 0, &pageCount);
+    EXPECT_EQ(string(out), "dead beef 01");
+    EXPECT_EQ(pageCount, 1);
+
+    // Pages of 5 chars over "dead beef 01"
+    const char *pages[] = {"dead ", "beef ", "01"};
+    for (uint8_t pageIdx = 0; pageIdx < 3; pageIdx++) {
+        pageHexString(out, 6, data, sizeof(data), false, 4, pageIdx, &pageCount);
+        EXPECT_EQ(pageCount, 3);
+        EXPECT_EQ(string(out), pages[pageIdx]);
+    }
+
+    pageHexString(out, 6, data, sizeof(data), false, 4, 3, &pageCount);
+    EXPECT_EQ(string(out), "");
+}
+
+TEST(FormatHelper, HexPageCountOutOfRange) {
+    const vector<uint8_t> data(256, 0xab);
+    char out[3] = {0};
+    uint8_t pageCount = 0;
+
+    // One byte per 2-char page, the 8-bit counter holds at most 255 pages
+    ASSERT_EQ(pageHexString(out, sizeof(out), data.data(), 255, false, 0, 254, &pageCount), parser_ok);
+    EXPECT_EQ(pageCount, 255);
+    EXPECT_EQ(string(out), "ab");
+
+    EXPECT_EQ(pageHexString(out, sizeof(out), data.data(), 256, false, 0, 0, &pageCount),
+              parser_display_page_out_of_range);
+    EXPECT_EQ(pageCount, 0);
+    EXPECT_EQ(string(out), "");
+}
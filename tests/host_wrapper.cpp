@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <json/json.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "spacemesh/tx.hpp"
+#include "utils/common.h"
+
+using namespace std;
+
+namespace {
+static_assert(!is_copy_constructible_v<spacemesh::ParsedTx>);
+static_assert(is_nothrow_move_constructible_v<spacemesh::ParsedTx>);
+
+// Same line format as dumpUI
+vector<string> dumpWrapper(const spacemesh::ParsedTx &tx, bool expert = false) {
+    vector<string> lines;
+    for (const auto item : expert ? tx.expertItems() : tx.items()) {
+        const uint8_t pageCount = item.pageCount();
+        for (uint8_t pageIdx = 0; pageIdx < pageCount; pageIdx++) {
+            const spacemesh::Page page = item.page(pageIdx);
+            stringstream ss;
+            ss << (int)item.index() << " | " << page.key();
+            if (page.count() > 1) {
+                ss << " [" << (int)pageIdx + 1 << "/" << (int)page.count() << "]";
+            }
+            ss << " : " << page.value();
+            lines.push_back(ss.str());
+        }
+    }
+    return lines;
+}
+}  // namespace
+
+TEST(HostWrapper, ItemsMatchCApi) {
+    for (const bool expert : {false, true}) {
+        for (const auto &tc : loadJsonTestcases("testcases.json")) {
+            const bool mainnet = tc["mainnet"].asBool();
+            const uint8_t flags = tc["compact"].asBool() ? DISPLAY_FLAG_COMPACT : 0;
+            const vector<uint8_t> blob = blobOf(tc);
+
+            const auto tx =
+                spacemesh::ParsedTx::parse(blob, flags, mainnet ? spacemesh::Network::Mainnet : spacemesh::Network::Testnet);
+
+            parser_tx_t txObj;
+            parser_context_t ctx;
+            ASSERT_EQ(parser_parse(&ctx, blob.data(), blob.size(), &txObj), parser_ok);
+            ctx.displayFlags = flags;
+            ctx.network = mainnet ? NETWORK_MAINNET : NETWORK_TESTNET;
+            ctx.expert = expert;
+
+            EXPECT_EQ(dumpWrapper(tx, expert), dumpUI(&ctx, 39, 39)) << tc["name"].asString();
+        }
+    }
+}
+
+TEST(HostWrapper, SpendAccessors) {
+    const vector<uint8_t> blob = blobNamed("sm_Wallet_spend");
+    const auto tx = spacemesh::ParsedTx::parse(blob);
+
+    EXPECT_EQ(tx.kind(), spacemesh::TxKind::Spend);
+    ASSERT_TRUE(tx.spend().has_value());
+    EXPECT_FALSE(tx.drain().has_value());
+    EXPECT_FALSE(tx.spawn().has_value());
+
+    // Views point into the caller's buffer
+    EXPECT_EQ(tx.genesisId().data(), blob.data());
+    EXPECT_EQ(tx.genesisId().size(), (size_t)GENESIS_LENGTH);
+    EXPECT_EQ(tx.principal().size(), (size_t)ADDRESS_LENGTH);
+    EXPECT_EQ(tx.spend()->destination.size(), (size_t)ADDRESS_LENGTH);
+    EXPECT_GE(tx.spend()->destination.data(), blob.data());
+    EXPECT_LT(tx.spend()->destination.data(), blob.data() + blob.size());
+    EXPECT_EQ(tx.spend()->amount, tx.raw().spend.amount);
+}
+
+TEST(HostWrapper, SpawnAccessors) {
+    const auto multisigBlob = blobNamed("sm_Multisig_5_7_spawn");
+    const auto multisig = spacemesh::ParsedTx::parse(multisigBlob);
+    ASSERT_TRUE(multisig.multisigSpawn().has_value());
+    EXPECT_FALSE(multisig.walletSpawn().has_value());
+    EXPECT_FALSE(multisig.vaultSpawn().has_value());
+    EXPECT_EQ(multisig.spawn()->accountType, MULTISIG);
+    EXPECT_EQ(multisig.multisigSpawn()->approvers(), 5);
+    EXPECT_EQ(multisig.multisigSpawn()->participants(), 7);
+    EXPECT_EQ(multisig.multisigSpawn()->pubkey(6).size(), 32u);
+    EXPECT_TRUE(multisig.multisigSpawn()->pubkey(7).empty());
+
+    const auto vaultBlob = blobNamed("sm_Vault_5_9_spawn");
+    const auto vault = spacemesh::ParsedTx::parse(vaultBlob);
+    ASSERT_TRUE(vault.vaultSpawn().has_value());
+    EXPECT_EQ(vault.vaultSpawn()->owner.size(), (size_t)ADDRESS_LENGTH);
+    EXPECT_LE(vault.vaultSpawn()->initialUnlockAmount, vault.vaultSpawn()->totalAmount);
+    EXPECT_LE(vault.vaultSpawn()->vestingStart, vault.vaultSpawn()->vestingEnd);
+
+    const auto drainBlob = blobNamed("sm_Vault_5_9_drain");
+    const auto drain = spacemesh::ParsedTx::parse(drainBlob);
+    ASSERT_TRUE(drain.drain().has_value());
+    EXPECT_EQ(drain.drain()->vault.size(), (size_t)ADDRESS_LENGTH);
+}
+
+TEST(HostWrapper, MoveKeepsRendering) {
+    const vector<uint8_t> blob = blobNamed("sm_Multisig_1_4_spawn");
+    auto tx = spacemesh::ParsedTx::parse(blob);
+    const vector<string> before = dumpWrapper(tx);
+
+    const spacemesh::ParsedTx moved = std::move(tx);
+    EXPECT_EQ(moved.context().tx_obj, &moved.raw());
+    EXPECT_EQ(dumpWrapper(moved), before);
+    EXPECT_FALSE(moved.items()[0].value().empty());
+
+    // Self-move leaves the tx usable, through an alias so the compiler does not flag it
+    auto self = spacemesh::ParsedTx::parse(blob);
+    spacemesh::ParsedTx &alias = self;
+    self = std::move(alias);
+    EXPECT_EQ(self.context().tx_obj, &self.raw());
+    EXPECT_EQ(dumpWrapper(self), before);
+}
+
+TEST(HostWrapper, Errors) {
+    vector<uint8_t> blob = blobNamed("sm_Wallet_spend");
+    blob.pop_back();
+    try {
+        (void)spacemesh::ParsedTx::parse(blob);
+        FAIL() << "truncated tx was accepted";
+    } catch (const spacemesh::Error &e) {
+        EXPECT_NE(e.code(), parser_ok);
+        EXPECT_STREQ(e.what(), parser_getErrorDescription(e.code()));
+    }
+
+    EXPECT_THROW((void)spacemesh::ParsedTx::parse(spacemesh::ByteSpan()), spacemesh::Error);
+
+    blob = blobNamed("sm_Wallet_spend");
+    const auto tx = spacemesh::ParsedTx::parse(blob);
+    EXPECT_THROW((void)tx.items(0), spacemesh::Error);
+    EXPECT_THROW((void)tx.items()[0].page(5), spacemesh::Error);
+}
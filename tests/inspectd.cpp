@@ -0,0 +1,187 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "inspector.h"
+#include "protocol.h"
+#include "server.h"
+#include "utils/common.h"
+
+using namespace std;
+
+namespace {
+struct Testcase {
+    string name;
+    inspectd::Request request;
+    vector<string> expected;
+    vector<string> expectedExpert;
+};
+
+vector<Testcase> loadTestcases(const string &file, inspectd::BlobType type) {
+    vector<Testcase> testcases;
+    for (const auto &tc : loadJsonTestcases(file)) {
+        Testcase t;
+        t.name = tc["name"].asString();
+        t.request.id = tc["index"].asUInt();
+        t.request.type = type;
+        t.request.flags = (tc["compact"].asBool() ? inspectd::FLAG_COMPACT : 0) |
+                          (tc.isMember("mainnet") && !tc["mainnet"].asBool() ? inspectd::FLAG_TESTNET : 0) |
+                          (tc["digest"].asBool() ? inspectd::FLAG_MESSAGE_DIGEST : 0);
+        t.request.blob = blobOf(tc);
+        for (const auto &s : tc["output"]) {
+            t.expected.push_back(s.asString());
+        }
+        for (const auto &s : tc["output_expert"]) {
+            t.expectedExpert.push_back(s.asString());
+        }
+        testcases.push_back(t);
+    }
+    return testcases;
+}
+
+int connectTo(const string &path) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    EXPECT_EQ(connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)), 0);
+    return fd;
+}
+
+bool readFrame(int fd, vector<uint8_t> *body) {
+    uint8_t len[inspectd::FRAME_LEN_SIZE];
+    if (recv(fd, len, sizeof(len), MSG_WAITALL) != sizeof(len)) {
+        return false;
+    }
+    body->resize(inspectd::readU32(len));
+    return recv(fd, body->data(), body->size(), MSG_WAITALL) == (ssize_t)body->size();
+}
+}  // namespace
+
+TEST(Inspectd, MatchesTestVectors) {
+    for (const auto &tc : loadTestcases("testcases.json", inspectd::BlobType::Tx)) {
+        const inspectd::Response response = inspectd::inspect(tc.request);
+        ASSERT_EQ(response.status, parser_ok) << tc.name;
+        EXPECT_EQ(response.id, tc.request.id);
+        EXPECT_EQ(response.lines, tc.expected) << tc.name;
+        EXPECT_EQ(response.expertLines, tc.expectedExpert) << tc.name;
+    }
+
+    for (const auto &tc : loadTestcases("message_testcases.json", inspectd::BlobType::Message)) {
+        const inspectd::Response response = inspectd::inspect(tc.request);
+        ASSERT_EQ(response.status, parser_ok) << tc.name;
+        EXPECT_EQ(response.lines, tc.expected) << tc.name;
+    }
+}
+
+TEST(Inspectd, RejectsBadRequests) {
+    inspectd::Request request = loadTestcases("testcases.json", inspectd::BlobType::Tx)[0].request;
+    request.blob.pop_back();
+    inspectd::Response response = inspectd::inspect(request);
+    EXPECT_NE(response.status, parser_ok);
+    EXPECT_TRUE(response.lines.empty());
+
+    request.type = static_cast<inspectd::BlobType>(7);
+    EXPECT_EQ(inspectd::inspect(request).status, parser_unexpected_type);
+
+    // A request body shorter than its header does not decode
+    const uint8_t shortBody[5] = {0};
+    EXPECT_FALSE(inspectd::decodeRequest(shortBody, sizeof(shortBody), &request));
+}
+
+TEST(Inspectd, ProtocolRoundTrip) {
+    const auto tc = loadTestcases("testcases.json", inspectd::BlobType::Tx)[6];
+
+    const vector<uint8_t> requestFrame = inspectd::encodeRequest(tc.request);
+    ASSERT_EQ(inspectd::readU32(requestFrame.data()), requestFrame.size() - inspectd::FRAME_LEN_SIZE);
+    inspectd::Request request;
+    ASSERT_TRUE(inspectd::decodeRequest(requestFrame.data() + inspectd::FRAME_LEN_SIZE,
+                                        requestFrame.size() - inspectd::FRAME_LEN_SIZE, &request));
+    EXPECT_EQ(request.id, tc.request.id);
+    EXPECT_EQ(request.flags, tc.request.flags);
+    EXPECT_EQ(request.blob, tc.request.blob);
+
+    const inspectd::Response expected = inspectd::inspect(request);
+    const vector<uint8_t> responseFrame = inspectd::encodeResponse(expected);
+    inspectd::Response response;
+    ASSERT_TRUE(inspectd::decodeResponse(responseFrame.data() + inspectd::FRAME_LEN_SIZE,
+                                         responseFrame.size() - inspectd::FRAME_LEN_SIZE, &response));
+    EXPECT_EQ(response.id, expected.id);
+    EXPECT_EQ(response.lines, expected.lines);
+    EXPECT_EQ(response.expertLines, expected.expertLines);
+}
+
+TEST(Inspectd, ConcurrentInspection) {
+    const auto testcases = loadTestcases("testcases.json", inspectd::BlobType::Tx);
+
+    vector<thread> threads;
+    vector<int> mismatches(4, 0);
+    for (size_t t = 0; t < mismatches.size(); t++) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < testcases.size(); i += 2) {
+                const inspectd::Response response = inspectd::inspect(testcases[i].request);
+                mismatches[t] += response.lines != testcases[i].expected ? 1 : 0;
+                mismatches[t] += response.expertLines != testcases[i].expectedExpert ? 1 : 0;
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    EXPECT_THAT(mismatches, testing::Each(0));
+}
+
+TEST(Inspectd, PipelinedRequestsOverSocket) {
+    const string path = "/tmp/inspectd-test-" + to_string(getpid()) + ".sock";
+    inspectd::Server server(path, 4);
+    ASSERT_TRUE(server.listen());
+    thread runner([&server] { server.run(); });
+
+    const auto testcases = loadTestcases("testcases.json", inspectd::BlobType::Tx);
+    const int fd = connectTo(path);
+
+    // All requests go out before any response is read
+    map<uint32_t, const Testcase *> byId;
+    for (const auto &tc : testcases) {
+        const vector<uint8_t> frame = inspectd::encodeRequest(tc.request);
+        ASSERT_EQ(send(fd, frame.data(), frame.size(), 0), (ssize_t)frame.size());
+        byId[tc.request.id] = &tc;
+    }
+
+    for (size_t i = 0; i < testcases.size(); i++) {
+        vector<uint8_t> body;
+        ASSERT_TRUE(readFrame(fd, &body));
+        inspectd::Response response;
+        ASSERT_TRUE(inspectd::decodeResponse(body.data(), body.size(), &response));
+        ASSERT_EQ(byId.count(response.id), 1u);
+        EXPECT_EQ(response.lines, byId[response.id]->expected);
+        EXPECT_EQ(response.expertLines, byId[response.id]->expectedExpert);
+        byId.erase(response.id);
+    }
+    EXPECT_TRUE(byId.empty());
+
+    close(fd);
+    server.stop();
+    runner.join();
+}
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "parser_message.h"
+#include "zxblake3.h"
+
+using namespace std;
+
+namespace {
+vector<uint8_t> messageBlob(const string &prefix, uint8_t domain, const vector<uint8_t> &message) {
+    vector<uint8_t> blob = {static_cast<uint8_t>(prefix.size()), static_cast<uint8_t>(prefix.size() >> 8),
+                            static_cast<uint8_t>(message.size()), static_cast<uint8_t>(message.size() >> 8)};
+    blob.insert(blob.end(), prefix.begin(), prefix.end());
+    blob.push_back(domain);
+    blob.insert(blob.end(), message.begin(), message.end());
+    return blob;
+}
+
+vector<uint8_t> binaryMessage(size_t len) {
+    vector<uint8_t> message(len);
+    for (size_t i = 0; i < len; i++) {
+        message[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    return message;
+}
+
+vector<uint8_t> oneShotDigest(const vector<uint8_t> &blob) {
+    parser_context_t ctx;
+    parser_message_tx_t msg;
+    EXPECT_EQ(parser_message_parse_streamed(&ctx, blob.data(), blob.size(), &msg, DISPLAY_FLAG_MESSAGE_DIGEST, nullptr),
+              parser_ok);
+    EXPECT_TRUE(msg.digestOnly);
+    return vector<uint8_t>(msg.digest, msg.digest + sizeof(msg.digest));
+}
+}  // namespace
+
+TEST(MessageDigest, StreamedMatchesOneShot) {
+    const vector<uint8_t> blob = messageBlob("prefix", HARE, binaryMessage(2048));
+    const vector<uint8_t> expected = oneShotDigest(blob);
+
+    // Chunk boundaries inside the header, the prefix, on the domain byte and inside the message
+    for (size_t chunkLen : {1, 3, 4, 5, 11, 250, 2100}) {
+        parser_message_digest_t streamed;
+        parser_message_digest_init(&streamed);
+        for (size_t offset = 0; offset < blob.size(); offset += chunkLen) {
+            const size_t len = min(chunkLen, blob.size() - offset);
+            ASSERT_EQ(parser_message_digest_update(&streamed, blob.data() + offset, static_cast<uint16_t>(len)),
+                      parser_ok);
+        }
+        EXPECT_TRUE(streamed.valid) << chunkLen;
+
+        parser_context_t ctx;
+        parser_message_tx_t msg;
+        ASSERT_EQ(
+            parser_message_parse_streamed(&ctx, blob.data(), blob.size(), &msg, DISPLAY_FLAG_MESSAGE_DIGEST, &streamed),
+            parser_ok);
+        EXPECT_EQ(vector<uint8_t>(msg.digest, msg.digest + sizeof(msg.digest)), expected) << chunkLen;
+    }
+}
+
+TEST(MessageDigest, FallsBackWhenStreamIsIncomplete) {
+    const vector<uint8_t> blob = messageBlob("", ATX, binaryMessage(500));
+    const vector<uint8_t> expected = oneShotDigest(blob);
+
+    // Another hash restarts the hasher halfway through the payload
+    parser_message_digest_t streamed;
+    parser_message_digest_init(&streamed);
+    ASSERT_EQ(parser_message_digest_update(&streamed, blob.data(), 200), parser_ok);
+    uint8_t other[MESSAGE_DIGEST_LEN];
+    ASSERT_EQ(zxblake3_hash(blob.data(), 10, other, sizeof(other)), parser_ok);
+    ASSERT_EQ(parser_message_digest_update(&streamed, blob.data() + 200, static_cast<uint16_t>(blob.size() - 200)),
+              parser_ok);
+    EXPECT_FALSE(streamed.valid);
+
+    parser_context_t ctx;
+    parser_message_tx_t msg;
+    ASSERT_EQ(parser_message_parse_streamed(&ctx, blob.data(), blob.size(), &msg, DISPLAY_FLAG_MESSAGE_DIGEST, &streamed),
+              parser_ok);
+    EXPECT_EQ(vector<uint8_t>(msg.digest, msg.digest + sizeof(msg.digest)), expected);
+
+    // Stream missing the last chunk
+    parser_message_digest_init(&streamed);
+    ASSERT_EQ(parser_message_digest_update(&streamed, blob.data(), 200), parser_ok);
+    ASSERT_EQ(parser_message_parse_streamed(&ctx, blob.data(), blob.size(), &msg, DISPLAY_FLAG_MESSAGE_DIGEST, &streamed),
+              parser_ok);
+    EXPECT_EQ(vector<uint8_t>(msg.digest, msg.digest + sizeof(msg.digest)), expected);
+}
+
+TEST(MessageDigest, CoversTheWholeBuffer) {
+    // Largest message the 16 KiB flash buffer holds, past what a depth-2 hasher accepts
+    const vector<uint8_t> blob = messageBlob("", HARE, binaryMessage(16 * 1024 - MESSAGE_HEADER_LEN - 1));
+    const vector<uint8_t> expected = oneShotDigest(blob);
+
+    parser_message_digest_t streamed;
+    parser_message_digest_init(&streamed);
+    for (size_t offset = 0; offset < blob.size(); offset += 250) {
+        const size_t len = min<size_t>(250, blob.size() - offset);
+        ASSERT_EQ(parser_message_digest_update(&streamed, blob.data() + offset, static_cast<uint16_t>(len)), parser_ok);
+    }
+    EXPECT_TRUE(streamed.valid);
+
+    parser_context_t ctx;
+    parser_message_tx_t msg;
+    ASSERT_EQ(parser_message_parse_streamed(&ctx, blob.data(), blob.size(), &msg, DISPLAY_FLAG_MESSAGE_DIGEST, &streamed),
+              parser_ok);
+    EXPECT_EQ(vector<uint8_t>(msg.digest, msg.digest + sizeof(msg.digest)), expected);
+}
+
+TEST(MessageDigest, OnlyLongBinaryMessages) {
+    parser_context_t ctx;
+    parser_message_tx_t msg;
+
+    const auto parse = [&](const vector<uint8_t> &blob, uint8_t displayFlags) {
+        return parser_message_parse_streamed(&ctx, blob.data(), blob.size(), &msg, displayFlags, nullptr);
+    };
+
+    vector<uint8_t> blob = messageBlob("", ATX, binaryMessage(128));
+    ASSERT_EQ(parse(blob, DISPLAY_FLAG_MESSAGE_DIGEST), parser_ok);
+    EXPECT_FALSE(msg.digestOnly);
+
+    blob = messageBlob("", ATX, vector<uint8_t>(4000, 'a'));
+    ASSERT_EQ(parse(blob, DISPLAY_FLAG_MESSAGE_DIGEST), parser_ok);
+    EXPECT_FALSE(msg.digestOnly);
+
+    // Without the display flag long binary messages keep their hex pages
+    blob = messageBlob("", ATX, binaryMessage(129));
+    ASSERT_EQ(parse(blob, 0), parser_ok);
+    EXPECT_FALSE(msg.digestOnly);
+
+    ASSERT_EQ(parse(blob, DISPLAY_FLAG_MESSAGE_DIGEST), parser_ok);
+    EXPECT_TRUE(msg.digestOnly);
+
+    uint8_t numItems = 0;
+    ASSERT_EQ(parser_message_getNumItems(&ctx, &numItems), parser_ok);
+    EXPECT_EQ(numItems, 5);
+}
+
+TEST(MessagePrintable, MatchesBytewiseCheck) {
+    // Every byte value at every position of a word and of the tail, on a text long enough for the word-wise scan
+    const string text = "Spacemesh proposal payload 001. Spacemesh proposal";
+    for (size_t pos = 0; pos < text.size(); pos++) {
+        for (int c = 0; c < 256; c++) {
+            vector<uint8_t> message(text.begin(), text.end());
+            message[pos] = static_cast<uint8_t>(c);
+            const vector<uint8_t> blob = messageBlob("", ATX, message);
+
+            parser_context_t ctx;
+            parser_message_tx_t msg;
+            ASSERT_EQ(parser_message_parse(&ctx, blob.data(), blob.size(), &msg), parser_ok);
+            EXPECT_EQ(msg.messagePrintable, static_cast<bool>(IS_PRINTABLE(c))) << pos << " " << c;
+            EXPECT_TRUE(msg.prefixPrintable);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "parser.h"
+#include "utils/common.h"
+
+using namespace std;
+
+namespace {
+parser_error_t parseBlob(const vector<uint8_t> &blob) {
+    parser_context_t ctx;
+    parser_tx_t tx;
+    return parser_parse(&ctx, blob.data(), blob.size(), &tx);
+}
+}  // namespace
+
+TEST(ParserMethods, RegistryErrors) {
+    // Genesis id, compact tx version and principal come before the selector
+    const size_t selectorOffset = GENESIS_LENGTH + 1 + ADDRESS_LENGTH;
+    const size_t templateTypeOffset = selectorOffset + 1 + ADDRESS_LENGTH - 1;
+
+    vector<uint8_t> blob = blobNamed("sm_Wallet_spend");
+    blob[selectorOffset] = 31 << 2;
+    EXPECT_EQ(parseBlob(blob), parser_unexpected_method_selector);
+
+    blob = blobNamed("sm_Wallet_spawn");
+    EXPECT_EQ(parseBlob(blob), parser_ok);
+    blob[templateTypeOffset] = 0x7F;
+    EXPECT_EQ(parseBlob(blob), parser_unexpected_value);
+
+    blob = blobNamed("sm_Wallet_spawn");
+    blob[GENESIS_LENGTH] = (TX_VERSION + 1) << 2;
+    EXPECT_EQ(parseBlob(blob), parser_unexpected_version);
+}
@@ -0,0 +1,308 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "parser.h"
+#include "parser_state.h"
+#include "utils/common.h"
+
+using namespace std;
+
+namespace {
+struct Testcase {
+    string name;
+    vector<uint8_t> blob;
+    uint8_t displayFlags;
+    network_e network;
+    vector<string> expected;
+};
+
+parser_error_t parseTestcase(parser_state_t *state, const Testcase &t) {
+    return parser_state_parseTx(state, t.blob.data(), t.blob.size(), t.displayFlags, t.network, false);
+}
+
+// Mainnet and testnet txs, rendered for the normal review
+vector<Testcase> loadTestcases() {
+    vector<Testcase> testcases;
+    for (const auto &tc : loadJsonTestcases("testcases.json")) {
+        Testcase t;
+        t.name = tc["name"].asString();
+        t.blob = blobOf(tc);
+        t.displayFlags = tc["compact"].asBool() ? DISPLAY_FLAG_COMPACT : 0;
+        t.network = tc["mainnet"].asBool() ? NETWORK_MAINNET : NETWORK_TESTNET;
+
+        // Reference output from a single parse, with nothing else alive
+        parser_state_t state;
+        if (parseTestcase(&state, t) != parser_ok) {
+            continue;
+        }
+        t.expected = dumpUI(&state.ctx, 39, 39);
+        testcases.push_back(move(t));
+    }
+    return testcases;
+}
+}  // namespace
+
+TEST(ParserState, IndependentStates) {
+    const vector<Testcase> testcases = loadTestcases();
+    ASSERT_FALSE(testcases.empty());
+
+    // All parsed up front, then rendered in reverse order
+    const auto states = make_unique<parser_state_t[]>(testcases.size());
+    for (size_t i = 0; i < testcases.size(); i++) {
+        const Testcase &t = testcases[i];
+        ASSERT_EQ(parseTestcase(&states[i], t), parser_ok);
+    }
+    for (size_t i = testcases.size(); i-- > 0;) {
+        EXPECT_EQ(dumpUI(&states[i].ctx, 39, 39), testcases[i].expected) << testcases[i].name;
+    }
+
+    // Items of different states requested alternately, so each display cache is hit between the others
+    for (size_t i = 0; i + 1 < testcases.size(); i += 2) {
+        uint8_t numItems[2] = {0};
+        ASSERT_EQ(parser_getNumItems(&states[i].ctx, &numItems[0]), parser_ok);
+        ASSERT_EQ(parser_getNumItems(&states[i + 1].ctx, &numItems[1]), parser_ok);
+        for (uint8_t idx = 0; idx < max(numItems[0], numItems[1]); idx++) {
+            for (size_t s = 0; s < 2; s++) {
+                if (idx >= numItems[s]) {
+                    continue;
+                }
+                char key[40];
+                char value[40];
+                uint8_t pageCount = 0;
+                ASSERT_EQ(parser_getItem(&states[i + s].ctx, idx, key, sizeof(key), value, sizeof(value), 0, &pageCount),
+                          parser_ok);
+            }
+        }
+        EXPECT_EQ(dumpUI(&states[i].ctx, 39, 39), testcases[i].expected) << testcases[i].name;
+        EXPECT_EQ(dumpUI(&states[i + 1].ctx, 39, 39), testcases[i + 1].expected) << testcases[i + 1].name;
+    }
+}
+
+TEST(ParserState, RevisitedItemsMatch) {
+    const vector<Testcase> testcases = loadTestcases();
+    ASSERT_FALSE(testcases.empty());
+
+    // Stepping backwards and forwards hits the address memo, which must render what a fresh pass does
+    for (const Testcase &t : testcases) {
+        parser_state_t state;
+        ASSERT_EQ(parseTestcase(&state, t), parser_ok);
+        uint8_t numItems = 0;
+        ASSERT_EQ(parser_getNumItems(&state.ctx, &numItems), parser_ok);
+
+        auto render = [&](uint8_t idx) {
+            char key[40];
+            char value[40];
+            uint8_t pageCount = 0;
+            EXPECT_EQ(parser_getItem(&state.ctx, idx, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+            return string(key) + " : " + value;
+        };
+        vector<string> forward;
+        for (uint8_t idx = 0; idx < numItems; idx++) {
+            forward.push_back(render(idx));
+        }
+        for (uint8_t idx = numItems; idx-- > 1;) {
+            EXPECT_EQ(render(idx), forward[idx]) << t.name;
+            EXPECT_EQ(render(idx - 1), forward[idx - 1]) << t.name;
+            EXPECT_EQ(render(idx), forward[idx]) << t.name;
+        }
+    }
+}
+
+TEST(ParserState, KeySetHashedOnlyByCompactReview) {
+    const vector<uint8_t> blob = blobNamed("sm_Multisig_5_7_spawn");
+    for (const uint8_t flags : {0, DISPLAY_FLAG_COMPACT}) {
+        parser_state_t state;
+        ASSERT_EQ(parser_state_parseTx(&state, blob.data(), blob.size(), flags, NETWORK_MAINNET, true), parser_ok);
+        const spawn_multisig_tx_t &multisig = state.obj.tx.spawn.multisig;
+        EXPECT_FALSE(multisig.keysetDigestReady);
+
+        // Only the compact review shows the digest, rendering it fills it once
+        dumpUI(&state.ctx, 39, 39);
+        ASSERT_EQ(multisig.keysetDigestReady, flags == DISPLAY_FLAG_COMPACT);
+        if (multisig.keysetDigestReady) {
+            uint8_t expected[KEYSET_DIGEST_LEN];
+            ASSERT_EQ(parser_keysetDigest(&state.obj.tx, expected, sizeof(expected)), parser_ok);
+            EXPECT_EQ(vector<uint8_t>(multisig.keysetDigest, multisig.keysetDigest + KEYSET_DIGEST_LEN),
+                      vector<uint8_t>(expected, expected + KEYSET_DIGEST_LEN));
+        }
+    }
+}
+
+TEST(ParserState, NetworkIsPerState) {
+    const vector<Testcase> testcases = loadTestcases();
+    ASSERT_FALSE(testcases.empty());
+    const Testcase &t = testcases.front();
+
+    parser_state_t mainnet;
+    parser_state_t testnet;
+    ASSERT_EQ(parser_state_parseTx(&mainnet, t.blob.data(), t.blob.size(), t.displayFlags, NETWORK_MAINNET, false),
+              parser_ok);
+    ASSERT_EQ(parser_state_parseTx(&testnet, t.blob.data(), t.blob.size(), t.displayFlags, NETWORK_TESTNET, false),
+              parser_ok);
+
+    char mainnetValue[80];
+    char testnetValue[80];
+    char key[40];
+    uint8_t pageCount = 0;
+    // Item 1 is the principal
+    ASSERT_EQ(parser_getItem(&mainnet.ctx, 1, key, sizeof(key), mainnetValue, sizeof(mainnetValue), 0, &pageCount),
+              parser_ok);
+    ASSERT_EQ(parser_getItem(&testnet.ctx, 1, key, sizeof(key), testnetValue, sizeof(testnetValue), 0, &pageCount),
+              parser_ok);
+    EXPECT_THAT(mainnetValue, testing::StartsWith("sm1"));
+    EXPECT_THAT(testnetValue, testing::StartsWith("stest1"));
+}
+
+TEST(ParserState, AddressMemoFollowsNetwork) {
+    const vector<Testcase> testcases = loadTestcases();
+    ASSERT_FALSE(testcases.empty());
+    const Testcase &t = testcases.front();
+
+    parser_state_t state;
+    ASSERT_EQ(parser_state_parseTx(&state, t.blob.data(), t.blob.size(), t.displayFlags, NETWORK_MAINNET, false),
+              parser_ok);
+
+    char value[80];
+    char key[40];
+    uint8_t pageCount = 0;
+    // Item 1 is the principal, item 0 moves the render cache off it so the second read goes through the memo
+    ASSERT_EQ(parser_getItem(&state.ctx, 1, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+    EXPECT_THAT(value, testing::StartsWith("sm1"));
+    ASSERT_EQ(parser_getItem(&state.ctx, 0, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+
+    state.ctx.network = NETWORK_TESTNET;
+    ASSERT_EQ(parser_getItem(&state.ctx, 1, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+    EXPECT_THAT(value, testing::StartsWith("stest1"));
+}
+
+TEST(ParserState, RenderCacheFollowsContext) {
+    const vector<uint8_t> blob = blobNamed("sm_Multisig_5_7_spawn");
+    parser_state_t reused;
+    parser_state_t compact;
+    parser_state_t testnet;
+    ASSERT_EQ(parser_state_parseTx(&reused, blob.data(), blob.size(), 0, NETWORK_MAINNET, false), parser_ok);
+    ASSERT_EQ(parser_state_parseTx(&compact, blob.data(), blob.size(), DISPLAY_FLAG_COMPACT, NETWORK_MAINNET, false),
+              parser_ok);
+    ASSERT_EQ(parser_state_parseTx(&testnet, blob.data(), blob.size(), 0, NETWORK_TESTNET, false), parser_ok);
+
+    char key[40];
+    char value[80];
+    char expectedKey[40];
+    char expectedValue[80];
+    uint8_t pageCount = 0;
+    // Each item is cached by the normal mainnet review, then read again after switching the context
+    const auto expectSwitchedItem = [&](parser_state_t *reference, uint8_t idx, uint8_t flags, network_e network) {
+        reused.ctx.displayFlags = 0;
+        reused.ctx.network = NETWORK_MAINNET;
+        ASSERT_EQ(parser_getItem(&reused.ctx, idx, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+        reused.ctx.displayFlags = flags;
+        reused.ctx.network = network;
+        ASSERT_EQ(parser_getItem(&reused.ctx, idx, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+        ASSERT_EQ(parser_getItem(&reference->ctx, idx, expectedKey, sizeof(expectedKey), expectedValue,
+                                 sizeof(expectedValue), 0, &pageCount),
+                  parser_ok);
+        EXPECT_STREQ(key, expectedKey) << "item " << static_cast<int>(idx);
+        EXPECT_STREQ(value, expectedValue) << "item " << static_cast<int>(idx);
+    };
+
+    uint8_t numItems = 0;
+    ASSERT_EQ(parser_getNumItems(&compact.ctx, &numItems), parser_ok);
+    for (uint8_t i = 0; i < numItems; i++) {
+        expectSwitchedItem(&compact, i, DISPLAY_FLAG_COMPACT, NETWORK_MAINNET);
+    }
+    ASSERT_EQ(parser_getNumItems(&testnet.ctx, &numItems), parser_ok);
+    for (uint8_t i = 0; i < numItems; i++) {
+        expectSwitchedItem(&testnet, i, 0, NETWORK_TESTNET);
+    }
+}
+
+TEST(ParserState, RelocateAfterCopy) {
+    const vector<Testcase> testcases = loadTestcases();
+    ASSERT_FALSE(testcases.empty());
+    const Testcase &t = testcases.front();
+
+    auto original = make_unique<parser_state_t>();
+    ASSERT_EQ(parseTestcase(original.get(), t), parser_ok);
+    parser_state_t copy = *original;
+    parser_state_relocate(&copy);
+    original.reset();
+
+    EXPECT_EQ(copy.ctx.tx_obj, &copy.obj.tx);
+    EXPECT_EQ(copy.ctx.cache, &copy.cache);
+    EXPECT_EQ(dumpUI(&copy.ctx, 39, 39), t.expected);
+}
+
+TEST(ParserState, ConcurrentParsing) {
+    const vector<Testcase> testcases = loadTestcases();
+
+    vector<thread> threads;
+    vector<int> mismatches(4, 0);
+    for (size_t t = 0; t < mismatches.size(); t++) {
+        threads.emplace_back([&, t] {
+            parser_state_t state;
+            for (size_t round = 0; round < 4; round++) {
+                for (size_t i = t; i < testcases.size(); i += 2) {
+                    const Testcase &tc = testcases[i];
+                    const parser_error_t err = parseTestcase(&state, tc);
+                    if (err != parser_ok || dumpUI(&state.ctx, 39, 39) != tc.expected) {
+                        mismatches[t]++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    EXPECT_THAT(mismatches, testing::Each(0));
+}
+
+TEST(ParserState, ValidateTxDiagnostics) {
+    const vector<Testcase> testcases = loadTestcases();
+    ASSERT_FALSE(testcases.empty());
+
+    parser_state_t state;
+    for (const auto &t : testcases) {
+        uint16_t errorOffset = 0;
+        uint8_t numItems = 0;
+        ASSERT_EQ(parser_state_validateTx(&state, t.blob.data(), t.blob.size(), t.displayFlags, t.network, false,
+                                          &errorOffset, &numItems),
+                  parser_ok)
+            << t.name;
+        EXPECT_EQ(errorOffset, t.blob.size()) << t.name;
+        EXPECT_EQ(numItems, t.expected.empty() ? 0 : stoi(t.expected.back()) + 1) << t.name;
+        // Nothing is kept for a review
+        EXPECT_EQ(state.ctx.tx_obj, nullptr);
+    }
+
+    // Truncated txs stop at the field that no longer fits
+    const Testcase &t = testcases.front();
+    for (size_t len = 1; len < t.blob.size(); len++) {
+        uint16_t errorOffset = UINT16_MAX;
+        uint8_t numItems = UINT8_MAX;
+        EXPECT_NE(parser_state_validateTx(&state, t.blob.data(), len, t.displayFlags, t.network, false, &errorOffset,
+                                          &numItems),
+                  parser_ok)
+            << len;
+        EXPECT_LE(errorOffset, len);
+        EXPECT_EQ(numItems, 0);
+    }
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "parser.h"
+#include "parser_methods.h"
+#include "utils/common.h"
+
+// Built into unittests_pruned, against an app_lib compiled without the vault spawn
+static_assert(PARSER_SPAWN_VAULT == 0, "tests/pruned needs PARSER_SPAWN_VAULT=0");
+
+using namespace std;
+
+namespace {
+parser_error_t parseBlob(const vector<uint8_t> &blob) {
+    parser_context_t ctx;
+    parser_tx_t tx;
+    return parser_parse(&ctx, blob.data(), blob.size(), &tx);
+}
+}  // namespace
+
+TEST(ParserMethodsPruned, VaultSpawnRejected) {
+    // Other spawn templates keep the selector known, so only the template is rejected
+    EXPECT_EQ(parseBlob(blobNamed("sm_Vault_1_1_spawn")), parser_unexpected_value);
+
+    EXPECT_EQ(parseBlob(blobNamed("sm_Vault_1_1_drain")), parser_ok);
+    EXPECT_EQ(parseBlob(blobNamed("sm_Wallet_spawn")), parser_ok);
+    EXPECT_EQ(parseBlob(blobNamed("sm_Multisig_5_7_spawn")), parser_ok);
+}
@@ -0,0 +1,229 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include <json/json.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "spacemesh/export.hpp"
+#include "utils/common.h"
+
+using namespace std;
+
+namespace {
+string hexOf(spacemesh::ByteSpan b) {
+    stringstream ss;
+    for (const uint8_t c : b) {
+        ss << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 0x0F];
+    }
+    return ss.str();
+}
+
+string toJson(const spacemesh::ParsedTx &tx) {
+    const size_t len = spacemesh::exportJson(tx, nullptr, 0);
+    string out(len, '\0');
+    EXPECT_EQ(spacemesh::exportJson(tx, out.data(), out.size()), len);
+    return out;
+}
+
+vector<uint8_t> toCbor(const spacemesh::ParsedTx &tx) {
+    vector<uint8_t> out(spacemesh::exportCbor(tx, nullptr, 0));
+    EXPECT_EQ(spacemesh::exportCbor(tx, out.data(), out.size()), out.size());
+    return out;
+}
+
+// Minimal CBOR reader for the subset the exporter emits, printed back as compact JSON
+class CborToJson {
+   public:
+    explicit CborToJson(const vector<uint8_t> &in) : in_(in) {}
+
+    bool convert(string *out) {
+        stringstream ss;
+        const bool ok = item(ss) && pos_ == in_.size();
+        *out = ss.str();
+        return ok;
+    }
+
+   private:
+    bool head(uint8_t *major, uint64_t *arg) {
+        if (pos_ >= in_.size()) {
+            return false;
+        }
+        *major = in_[pos_] >> 5;
+        const uint8_t info = in_[pos_++] & 0x1F;
+        if (info < 24) {
+            *arg = info;
+            return true;
+        }
+        if (info > 27) {
+            return false;
+        }
+        const size_t len = size_t{1} << (info - 24);
+        if (in_.size() - pos_ < len) {
+            return false;
+        }
+        *arg = 0;
+        for (size_t i = 0; i < len; i++) {
+            *arg = (*arg << 8) | in_[pos_++];
+        }
+        // Deterministic encoding: the argument must not fit a shorter form
+        const uint64_t minimum = len == 1 ? 24 : (uint64_t{1} << (4 * len));
+        return *arg >= minimum;
+    }
+
+    bool item(stringstream &ss) {
+        uint8_t major = 0;
+        uint64_t arg = 0;
+        if (!head(&major, &arg)) {
+            return false;
+        }
+        switch (major) {
+            case 0:
+                ss << arg;
+                return true;
+            case 2:
+            case 3:
+                if (in_.size() - pos_ < arg) {
+                    return false;
+                }
+                ss << '"';
+                if (major == 2) {
+                    ss << hexOf(spacemesh::ByteSpan(in_.data() + pos_, arg));
+                } else {
+                    ss << string(reinterpret_cast<const char *>(in_.data() + pos_), arg);
+                }
+                ss << '"';
+                pos_ += arg;
+                return true;
+            case 4:
+                ss << '[';
+                for (uint64_t i = 0; i < arg; i++) {
+                    ss << (i > 0 ? "," : "");
+                    if (!item(ss)) {
+                        return false;
+                    }
+                }
+                ss << ']';
+                return true;
+            case 5:
+                ss << '{';
+                for (uint64_t i = 0; i < arg; i++) {
+                    ss << (i > 0 ? "," : "");
+                    if (!item(ss)) {
+                        return false;
+                    }
+                    ss << ':';
+                    if (!item(ss)) {
+                        return false;
+                    }
+                }
+                ss << '}';
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    const vector<uint8_t> &in_;
+    size_t pos_ = 0;
+};
+
+Json::Value parseJson(const string &text) {
+    Json::CharReaderBuilder builder;
+    Json::Value obj;
+    JSONCPP_STRING errs;
+    istringstream in(text);
+    EXPECT_TRUE(Json::parseFromStream(builder, in, &obj, &errs)) << errs << "\n" << text;
+    return obj;
+}
+}  // namespace
+
+TEST(TxExport, JsonAndCborAgreeOnAllTestVectors) {
+    for (const auto &tc : loadJsonTestcases("testcases.json")) {
+        const vector<uint8_t> blob = blobOf(tc);
+        const auto tx = spacemesh::ParsedTx::parse(blob);
+
+        const string json = toJson(tx);
+        const Json::Value obj = parseJson(json);
+        EXPECT_EQ(obj["nonce"].asUInt64(), tx.nonce()) << tc["name"].asString();
+        EXPECT_EQ(obj["principal"].asString(), hexOf(tx.principal())) << tc["name"].asString();
+
+        string fromCbor;
+        EXPECT_TRUE(CborToJson(toCbor(tx)).convert(&fromCbor)) << tc["name"].asString();
+        EXPECT_EQ(fromCbor, json) << tc["name"].asString();
+    }
+}
+
+TEST(TxExport, SpendFields) {
+    const vector<uint8_t> blob = blobNamed("sm_Wallet_spend");
+    const auto tx = spacemesh::ParsedTx::parse(blob);
+    const Json::Value obj = parseJson(toJson(tx));
+
+    EXPECT_EQ(obj.size(), 8u);
+    EXPECT_EQ(obj["method"].asString(), "spend");
+    EXPECT_EQ(obj["version"].asUInt(), 0u);
+    EXPECT_EQ(obj["genesis"].asString(), hexOf(tx.genesisId()));
+    EXPECT_EQ(obj["gas_price"].asUInt64(), tx.gasPrice());
+    EXPECT_EQ(obj["destination"].asString(), hexOf(tx.spend()->destination));
+    EXPECT_EQ(obj["amount"].asUInt64(), tx.spend()->amount);
+
+    // Definite-length map of 8 entries, then the "method" key and its value
+    const vector<uint8_t> cbor = toCbor(tx);
+    const vector<uint8_t> prefix = {0xA8, 0x66, 'm', 'e', 't', 'h', 'o', 'd', 0x65, 's', 'p', 'e', 'n', 'd'};
+    ASSERT_GE(cbor.size(), prefix.size());
+    EXPECT_TRUE(equal(prefix.begin(), prefix.end(), cbor.begin()));
+}
+
+TEST(TxExport, SpawnFields) {
+    const vector<uint8_t> multisigBlob = blobNamed("sm_Multisig_5_7_spawn");
+    const auto multisig = spacemesh::ParsedTx::parse(multisigBlob);
+    Json::Value obj = parseJson(toJson(multisig));
+    EXPECT_EQ(obj["account_type"].asString(), "multisig");
+    EXPECT_EQ(obj["approvers"].asUInt(), 5u);
+    ASSERT_EQ(obj["pubkeys"].size(), 7u);
+    EXPECT_EQ(obj["pubkeys"][6].asString(), hexOf(multisig.multisigSpawn()->pubkey(6)));
+
+    const vector<uint8_t> vaultBlob = blobNamed("sm_Vault_5_9_spawn");
+    const auto vault = spacemesh::ParsedTx::parse(vaultBlob);
+    obj = parseJson(toJson(vault));
+    EXPECT_EQ(obj["account_type"].asString(), "vault");
+    EXPECT_EQ(obj["owner"].asString(), hexOf(vault.vaultSpawn()->owner));
+    EXPECT_EQ(obj["total_amount"].asUInt64(), vault.vaultSpawn()->totalAmount);
+    EXPECT_EQ(obj["initial_unlock_amount"].asUInt64(), vault.vaultSpawn()->initialUnlockAmount);
+    EXPECT_EQ(obj["vesting_start"].asUInt(), vault.vaultSpawn()->vestingStart);
+    EXPECT_EQ(obj["vesting_end"].asUInt(), vault.vaultSpawn()->vestingEnd);
+
+    const vector<uint8_t> walletBlob = blobNamed("sm_Wallet_spawn");
+    const auto wallet = spacemesh::ParsedTx::parse(walletBlob);
+    obj = parseJson(toJson(wallet));
+    EXPECT_EQ(obj["account_type"].asString(), "wallet");
+    EXPECT_EQ(obj["pubkey"].asString(), hexOf(wallet.walletSpawn()->pubkey));
+}
+
+TEST(TxExport, ShortBufferReportsFullLength) {
+    const vector<uint8_t> blob = blobNamed("sm_Multisig_9_10_spawn");
+    const auto tx = spacemesh::ParsedTx::parse(blob);
+    const vector<uint8_t> full = toCbor(tx);
+
+    for (const size_t cap : {size_t{0}, size_t{1}, full.size() / 2, full.size() - 1}) {
+        vector<uint8_t> out(full.size() + 4, 0xEE);
+        EXPECT_EQ(spacemesh::exportCbor(tx, out.data(), cap), full.size());
+        EXPECT_TRUE(equal(out.begin(), out.begin() + cap, full.begin()));
+        EXPECT_TRUE(all_of(out.begin() + cap, out.end(), [](uint8_t b) { return b == 0xEE; }));
+    }
+}
@@ -14,14 +14,11 @@
  *  limitations under the License.
  ********************************************************************************/
 
-#include <hexutils.h>
 #include <json/json.h>
 #include <parser_txdef.h>
 
-#include <fstream>
 #include <iostream>
 
-#include "app_mode.h"
 #include "crypto.h"
 #include "gmock/gmock.h"
 #include "parser.h"
@@ -34,7 +31,9 @@ typedef struct {
     uint64_t index;
     std::string name;
     bool mainnet;
-    std::string blob;
+    bool compact;
+    bool digest;
+    std::vector<uint8_t> blob;
     std::vector<std::string> expected;
     std::vector<std::string> expected_expert;
 } testcase_t;
@@ -65,23 +64,12 @@ class JsonTestsB : public ::testing::TestWithParam<testcase_t> {
     };
 };
 
-// Retrieve testcases from json file
-std::vector<testcase_t> GetJsonTestCases(std::string jsonFile) {
+// Retrieve testcases from json file. Corpus.MatchesTestVectors checks the same vectors through the binary corpus, these
+// tests keep the expected lines so a mismatch shows which line differs.
+std::vector<testcase_t> GetJsonTestCases(const std::string &jsonFile) {
     auto answer = std::vector<testcase_t>();
 
-    Json::CharReaderBuilder builder;
-    Json::Value obj;
-
-    std::string fullPathJsonFile = std::string(TESTVECTORS_DIR) + jsonFile;
-
-    std::ifstream inFile(fullPathJsonFile);
-    if (!inFile.is_open()) {
-        return answer;
-    }
-
-    // Retrieve all test cases
-    JSONCPP_STRING errs;
-    Json::parseFromStream(builder, inFile, &obj, &errs);
+    const Json::Value obj = loadJsonTestcases(jsonFile);
     std::cout << "Number of testcases: " << obj.size() << std::endl;
 
     for (int i = 0; i < obj.size(); i++) {
@@ -96,32 +84,32 @@ std::vector<testcase_t> GetJsonTestCases(std::string jsonFile) {
         }
 
         answer.push_back(testcase_t{obj[i]["index"].asUInt64(), obj[i]["name"].asString(), obj[i]["mainnet"].asBool(),
-                                    obj[i]["blob"].asString(), outputs, outputs_expert});
+                                    obj[i]["compact"].asBool(), obj[i]["digest"].asBool(), blobOf(obj[i]), outputs,
+                                    outputs_expert});
     }
 
     return answer;
 }
 
 void check_testcase(const testcase_t &tc, bool expert_mode) {
-    app_mode_set_expert(expert_mode);
-
     parser_context_t ctx;
     parser_error_t err;
 
-    uint8_t buffer[5000];
-    uint16_t bufferLen = parseHexString(buffer, sizeof(buffer), tc.blob.c_str());
-
     parser_tx_t tx_obj;
     memset(&tx_obj, 0, sizeof(tx_obj));
 
-    hdPath[0] = HDPATH_0_DEFAULT;
-    hdPath[1] = HDPATH_1_DEFAULT;
-    if (!tc.mainnet) {
-        hdPath[1] = HDPATH_1_TESTNET;
+    err = parser_parse(&ctx, tc.blob.data(), tc.blob.size(), &tx_obj);
+    ASSERT_EQ(err, parser_ok) << parser_getErrorDescription(err);
+
+    ctx.network = tc.mainnet ? NETWORK_MAINNET : NETWORK_TESTNET;
+    ctx.expert = expert_mode;
+
+    if (tc.compact) {
+        ctx.displayFlags = DISPLAY_FLAG_COMPACT;
     }
 
-    err = parser_parse(&ctx, buffer, bufferLen, &tx_obj);
-    ASSERT_EQ(err, parser_ok) << parser_getErrorDescription(err);
+    parser_display_cache_t cache;
+    parser_attach_cache(&ctx, &cache);
 
     auto output = dumpUI(&ctx, 39, 39);
 
@@ -131,7 +119,7 @@ void check_testcase(const testcase_t &tc, bool expert_mode) {
     }
     std::cout << std::endl << std::endl;
 
-    std::vector<std::string> expected = app_mode_expert() ? tc.expected_expert : tc.expected;
+    std::vector<std::string> expected = expert_mode ? tc.expected_expert : tc.expected;
 
     EXPECT_EQ(output.size(), expected.size());
     for (size_t i = 0; i < expected.size(); i++) {
@@ -141,22 +129,40 @@ void check_testcase(const testcase_t &tc, bool expert_mode) {
     }
 }
 
-void check_message_testcase(const testcase_t &tc) {
-    app_mode_set_expert(false);
+void check_testcase_both_modes(const testcase_t &tc) {
+    parser_context_t ctx;
+
+    parser_tx_t tx_obj;
+    memset(&tx_obj, 0, sizeof(tx_obj));
+
+    const parser_error_t err = parser_parse(&ctx, tc.blob.data(), tc.blob.size(), &tx_obj);
+    ASSERT_EQ(err, parser_ok) << parser_getErrorDescription(err);
+
+    ctx.network = tc.mainnet ? NETWORK_MAINNET : NETWORK_TESTNET;
+    if (tc.compact) {
+        ctx.displayFlags = DISPLAY_FLAG_COMPACT;
+    }
+
+    parser_display_cache_t cache;
+    parser_attach_cache(&ctx, &cache);
 
+    std::vector<std::string> output;
+    std::vector<std::string> outputExpert;
+    dumpUIBothModes(&ctx, 39, 39, &output, &outputExpert);
+
+    EXPECT_THAT(output, testing::ElementsAreArray(tc.expected));
+    EXPECT_THAT(outputExpert, testing::ElementsAreArray(tc.expected_expert));
+}
+
+void check_message_testcase(const testcase_t &tc) {
     parser_context_t ctx;
     parser_error_t err;
 
-    uint8_t buffer[5000];
-    uint16_t bufferLen = parseHexString(buffer, sizeof(buffer), tc.blob.c_str());
-
     parser_message_tx_t tx_obj;
     memset(&tx_obj, 0, sizeof(tx_obj));
 
-    hdPath[0] = HDPATH_0_DEFAULT;
-    hdPath[1] = HDPATH_1_DEFAULT;
-
-    err = parser_message_parse(&ctx, buffer, bufferLen, &tx_obj);
+    err = parser_message_parse_streamed(&ctx, tc.blob.data(), tc.blob.size(), &tx_obj,
+                                        tc.digest ? DISPLAY_FLAG_MESSAGE_DIGEST : 0, nullptr);
     ASSERT_EQ(err, parser_ok) << parser_getErrorDescription(err);
 
     auto output = dumpRawUI(&ctx, 39, 39);
@@ -167,7 +173,7 @@ void check_message_testcase(const testcase_t &tc) {
     }
     std::cout << std::endl << std::endl;
 
-    std::vector<std::string> expected = app_mode_expert() ? tc.expected_expert : tc.expected;
+    std::vector<std::string> expected = tc.expected;
 
     EXPECT_EQ(output.size(), expected.size());
     for (size_t i = 0; i < expected.size(); i++) {
@@ -189,5 +195,6 @@ INSTANTIATE_TEST_SUITE_P
 
 TEST_P(JsonTestsA, CheckUIOutput_CurrentTX_Expert) { check_testcase(GetParam(), true); }
 TEST_P(JsonTestsA, CheckUIOutput_CurrentTX) { check_testcase(GetParam(), false); }
+TEST_P(JsonTestsA, CheckUIOutput_CurrentTX_BothModes) { check_testcase_both_modes(GetParam()); }
 
 TEST_P(JsonTestsB, CheckUIOutput_RawTX) { check_message_testcase(GetParam()); }
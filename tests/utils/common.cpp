@@ -15,12 +15,49 @@
  ********************************************************************************/
 #include "common.h"
 
+#include <hexutils.h>
 #include <parser.h>
 #include <parser_message.h>
 
+#include <fstream>
 #include <sstream>
 #include <string>
 
+#include "gmock/gmock.h"
+
+namespace {
+void dumpItem(parser_context_t *ctx, uint16_t idx, uint16_t maxKeyLen, uint16_t maxValueLen,
+              std::vector<std::string> *answer) {
+    char keyBuffer[1000];
+    char valueBuffer[1000];
+    uint8_t pageIdx = 0;
+    uint8_t pageCount = 1;
+
+    while (pageIdx < pageCount) {
+        std::stringstream ss;
+
+        const parser_error_t err =
+            parser_getItem(ctx, idx, keyBuffer, maxKeyLen, valueBuffer, maxValueLen, pageIdx, &pageCount);
+
+        ss << idx << " | " << keyBuffer;
+        if (pageCount > 1) {
+            ss << " [" << (int)pageIdx + 1 << "/" << (int)pageCount << "]";
+        }
+        ss << " : ";
+
+        if (err == parser_ok) {
+            ss << valueBuffer;
+        } else {
+            ss << parser_getErrorDescription(err);
+        }
+
+        answer->push_back(ss.str());
+
+        pageIdx++;
+    }
+}
+}  // namespace
+
 std::vector<std::string> dumpUI(parser_context_t *ctx, uint16_t maxKeyLen, uint16_t maxValueLen) {
     auto answer = std::vector<std::string>();
 
@@ -31,42 +68,41 @@ std::vector<std::string> dumpUI(parser_context_t *ctx, uint16_t maxKeyLen, uint1
     }
 
     for (uint16_t idx = 0; idx < numItems; idx++) {
-        char keyBuffer[1000];
-        char valueBuffer[1000];
-        uint8_t pageIdx = 0;
-        uint8_t pageCount = 1;
-
-        while (pageIdx < pageCount) {
-            std::stringstream ss;
-
-            err = parser_getItem(ctx, idx, keyBuffer, maxKeyLen, valueBuffer, maxValueLen, pageIdx, &pageCount);
+        dumpItem(ctx, idx, maxKeyLen, maxValueLen, &answer);
+    }
 
-            ss << idx << " | " << keyBuffer;
-            if (pageCount > 1) {
-                ss << " [" << (int)pageIdx + 1 << "/" << (int)pageCount << "]";
-            }
-            ss << " : ";
+    return answer;
+}
 
-            if (err == parser_ok) {
-                ss << valueBuffer;
-            } else {
-                ss << parser_getErrorDescription(err);
-            }
+void dumpUIBothModes(parser_context_t *ctx, uint16_t maxKeyLen, uint16_t maxValueLen, std::vector<std::string> *lines,
+                     std::vector<std::string> *expertLines) {
+    lines->clear();
+    expertLines->clear();
 
-            answer.push_back(ss.str());
+    ctx->expert = true;
+    uint8_t numItems = 0;
+    uint8_t numItemsExpert = 0;
+    if (parser_getNumItemsBothModes(ctx, &numItems, &numItemsExpert) != parser_ok) {
+        return;
+    }
 
-            pageIdx++;
+    // Every item is rendered once, the normal review ends where the expert-only items start
+    for (uint16_t idx = 0; idx < numItemsExpert; idx++) {
+        if (idx == numItems) {
+            *lines = *expertLines;
         }
+        dumpItem(ctx, idx, maxKeyLen, maxValueLen, expertLines);
+    }
+    if (numItems >= numItemsExpert) {
+        *lines = *expertLines;
     }
-
-    return answer;
 }
 
 std::vector<std::string> dumpRawUI(parser_context_t *ctx, uint16_t maxKeyLen, uint16_t maxValueLen) {
     auto answer = std::vector<std::string>();
 
     uint8_t numItems;
-    parser_error_t err = parser_message_getNumItems(&numItems);
+    parser_error_t err = parser_message_getNumItems(ctx, &numItems);
     if (err != parser_ok) {
         return answer;
     }
@@ -102,3 +138,28 @@ std::vector<std::string> dumpRawUI(parser_context_t *ctx, uint16_t maxKeyLen, ui
 
     return answer;
 }
+
+Json::Value loadJsonTestcases(const std::string &file) {
+    Json::CharReaderBuilder builder;
+    Json::Value obj;
+    JSONCPP_STRING errs;
+    std::ifstream inFile(std::string(TESTVECTORS_DIR) + file);
+    EXPECT_TRUE(Json::parseFromStream(builder, inFile, &obj, &errs)) << file << ": " << errs;
+    return obj;
+}
+
+std::vector<uint8_t> blobOf(const Json::Value &tc) {
+    std::vector<uint8_t> blob(tc["blob"].asString().size() / 2);
+    blob.resize(parseHexString(blob.data(), blob.size(), tc["blob"].asCString()));
+    return blob;
+}
+
+std::vector<uint8_t> blobNamed(const std::string &name) {
+    for (const auto &tc : loadJsonTestcases("testcases.json")) {
+        if (tc["name"].asString() == name) {
+            return blobOf(tc);
+        }
+    }
+    ADD_FAILURE() << "testcase " << name << " not found";
+    return {};
+}
@@ -13,10 +13,22 @@
  *  See the License for the specific language governing permissions and
  *  limitations under the License.
  ********************************************************************************/
+#include <json/json.h>
+
 #include <string>
 #include <vector>
 
 #include "parser_common.h"
 
 std::vector<std::string> dumpUI(parser_context_t *ctx, uint16_t maxKeyLen, uint16_t maxValueLen);
+// Normal and expert review of a tx from one pass over its items, sets ctx->expert
+void dumpUIBothModes(parser_context_t *ctx, uint16_t maxKeyLen, uint16_t maxValueLen, std::vector<std::string> *lines,
+                     std::vector<std::string> *expertLines);
 std::vector<std::string> dumpRawUI(parser_context_t *ctx, uint16_t maxKeyLen, uint16_t maxValueLen);
+
+// Test vectors under TESTVECTORS_DIR, e.g. "testcases.json". Fails the current test if the file does not parse.
+Json::Value loadJsonTestcases(const std::string &file);
+// Decoded "blob" field of a test vector
+std::vector<uint8_t> blobOf(const Json::Value &tc);
+// Blob of the testcases.json entry with this name, fails the current test if there is none
+std::vector<uint8_t> blobNamed(const std::string &name);